@@ -0,0 +1,147 @@
+/*
+  main.cpp — simulated RunCam Split UART responder (Randall)
+
+  Purpose:
+    - Stand in for the Split-H on the bench so the rcdp backend
+      (CFG_DVR_UART 1) can be exercised without a camera
+    - Answer GET_DEVICE_INFO, act on CAMERA_CONTROL start/stop recording
+    - Mimic the DVR status LED on a pin, so the controller's LED classifier
+      confirms the state change exactly as it would with the real camera
+
+  Wiring (second Nano = "camera"):
+    camera D1 (TX)  -> controller D0 (RX)
+    camera D0 (RX)  <- controller D1 (TX)
+    camera D3       -> controller PD3 (DVR LED sense), common GND
+    Controller build: CFG_DVR_UART 1, CFG_DEBUG_SERIAL 0.
+
+  Behaviour:
+    - LED line: LOW = LED ON (same polarity as the real DVR output)
+    - Idle: solid ON. Recording: 1000/1000 ms slow blink.
+    - Pin 13 flashes on every valid frame received.
+    - Optional fault injection (compile-time below): drop replies, corrupt CRC.
+*/
+
+#include <Arduino.h>
+
+#include "crc8.h"
+
+// ----------------------------------------------------------------------------
+// Options
+// ----------------------------------------------------------------------------
+static constexpr uint8_t  PIN_FAKE_LED     = 3;
+static constexpr uint8_t  PIN_ACTIVITY     = 13;
+static constexpr uint32_t UART_BAUD        = 115200;
+
+static constexpr uint8_t  PROTOCOL_VERSION = 0x01;
+static constexpr uint16_t FEATURES         = (1u << 6) | (1u << 7);   // start/stop recording
+
+static constexpr uint8_t  DROP_EVERY_N     = 0;   // 0 = never drop a reply
+static constexpr uint8_t  CORRUPT_EVERY_N  = 0;   // 0 = never corrupt a reply
+
+// ----------------------------------------------------------------------------
+// State
+// ----------------------------------------------------------------------------
+static bool     s_recording   = false;
+static bool     s_led_on      = true;
+static uint32_t s_led_next_ms = 0;
+static uint32_t s_act_off_ms  = 0;
+
+static uint8_t  s_buf[4];
+static uint8_t  s_n = 0;
+static uint8_t  s_replies = 0;
+
+static void fake_led(bool on)
+{
+    digitalWrite(PIN_FAKE_LED, on ? LOW : HIGH);
+    s_led_on = on;
+}
+
+static void activity(void)
+{
+    digitalWrite(PIN_ACTIVITY, HIGH);
+    s_act_off_ms = millis() + 20;
+}
+
+static void reply_device_info(void)
+{
+    s_replies++;
+    if (DROP_EVERY_N && (s_replies % DROP_EVERY_N) == 0)
+        return;
+
+    uint8_t r[5] = { 0xCC, PROTOCOL_VERSION, (uint8_t)FEATURES, (uint8_t)(FEATURES >> 8), 0 };
+    r[4] = crc8_dvb_s2(r, 4);
+    if (CORRUPT_EVERY_N && (s_replies % CORRUPT_EVERY_N) == 0)
+        r[4] ^= 0x01;
+
+    Serial.write(r, sizeof(r));
+}
+
+static void on_byte(uint8_t b)
+{
+    if (s_n == 0 && b != 0xCC)
+        return;
+
+    s_buf[s_n++] = b;
+
+    // CC 00 crc : GET_DEVICE_INFO
+    if (s_n == 3 && s_buf[1] == 0x00)
+    {
+        if (crc8_dvb_s2(s_buf, 2) == s_buf[2])
+        {
+            activity();
+            reply_device_info();
+        }
+        s_n = 0;
+        return;
+    }
+
+    // CC 01 action crc : CAMERA_CONTROL (no reply)
+    if (s_n == 4)
+    {
+        if (s_buf[1] == 0x01 && crc8_dvb_s2(s_buf, 3) == s_buf[3])
+        {
+            activity();
+            if (s_buf[2] == 0x03) s_recording = true;
+            if (s_buf[2] == 0x04) s_recording = false;
+            s_led_next_ms = millis();
+        }
+        s_n = 0;
+    }
+}
+
+void setup()
+{
+    pinMode(PIN_FAKE_LED, OUTPUT);
+    pinMode(PIN_ACTIVITY, OUTPUT);
+    fake_led(true);
+
+    Serial.begin(UART_BAUD);
+}
+
+void loop()
+{
+    const uint32_t now = millis();
+
+    while (Serial.available() > 0)
+        on_byte((uint8_t)Serial.read());
+
+    if (s_act_off_ms && (int32_t)(now - s_act_off_ms) >= 0)
+    {
+        digitalWrite(PIN_ACTIVITY, LOW);
+        s_act_off_ms = 0;
+    }
+
+    if ((int32_t)(now - s_led_next_ms) < 0)
+        return;
+
+    if (s_recording)
+    {
+        fake_led(!s_led_on);
+        s_led_next_ms = now + 1000;
+    }
+    else
+    {
+        fake_led(true);
+        s_led_next_ms = now + 100;
+    }
+}
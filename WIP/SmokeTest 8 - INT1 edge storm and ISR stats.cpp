@@ -0,0 +1,259 @@
+/*
+  main.cpp — INT1 edge storm / ISR stats smoke test (Randall)
+
+  Purpose:
+    - Drive PD3 at known rates and check the counters isr_stats and dvr_led
+      report for them: probe count + latency, INT1 entries, ring drops,
+      storm trips / re-arm
+    - Check the COMPB latency probe survives an interrupts-off stall longer
+      than its 1 ms period (it must keep firing, not fall silent for a
+      32 ms Timer1 wrap)
+
+  Setup:
+    - BARE Nano, nothing on D3: PD3 is switched to an output and toggled by
+      this sketch. INT0/INT1 fire on output changes too (ATmega328P
+      datasheet, External Interrupts), so no generator board is needed.
+      Do NOT run this on the controller board: D3 is driven by the LED
+      mirror stage there.
+    - Controller build: CFG_ISR_STATS 1, CFG_DEBUG_SERIAL 1,
+      CFG_DVR_LED_ISR_CLASSIFIER 0 (ring mode), CFG_DVR_LED_STORM_GUARD 1.
+
+  Phases (each prints PASS/FAIL, summary at the end):
+    1) quiet 1 s            : probes ~1000, no INT1
+    2) 20 edges @ 50 ms     : INT1 +20, no drops, no storm (poll running)
+    3) 80 edges @ 5 ms      : poll NOT running => 63 stored, 17 dropped
+    4) 100 ms @ 10 kHz      : storm: INT1 masked after 9 entries, 1 trip,
+                              sampler hands INT1 back within 1 s of quiet
+    5) 10 x 1.5 ms cli()    : probe keeps firing (>= 80 probes / 100 ms),
+                              lat_max >= stall - probe period
+    6) 10 edges @ 50 ms     : INT1 re-armed, +10, no new drops
+*/
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "pins.h"
+#include "hw_timer.h"
+#include "isr_stats.h"
+#include "dvr_led.h"
+
+#if !CFG_ISR_STATS || CFG_DVR_LED_ISR_CLASSIFIER || !CFG_DVR_LED_STORM_GUARD
+  #error "SmokeTest 8 needs CFG_ISR_STATS 1, CFG_DVR_LED_ISR_CLASSIFIER 0, CFG_DVR_LED_STORM_GUARD 1"
+#endif
+
+// ----------------------------------------------------------------------------
+// Expectations (mirror dvr_led.cpp: QN = 64 ring, STORM_EDGES = 8)
+// ----------------------------------------------------------------------------
+static constexpr uint8_t  RING_SLOTS       = 63;    // QN - 1 usable
+static constexpr uint8_t  OVERFLOW_EDGES   = 80;
+static constexpr uint8_t  STORM_ENTRIES    = 9;     // STORM_EDGES + the masking one
+static constexpr uint16_t STALL_US         = 1500;  // > 1 ms probe period
+static constexpr uint16_t PROBE_US         = 1000;  // isr_stats kProbePeriodTk
+
+static uint8_t s_fail = 0;
+
+// ----------------------------------------------------------------------------
+// Helpers
+// ----------------------------------------------------------------------------
+static inline void pd3_toggle(void)
+{
+    PIND = _BV(PIND3);   // writing PINx toggles PORTx
+}
+
+static void check(const __FlashStringHelper* what, bool ok)
+{
+    Serial.print(ok ? F("  PASS ") : F("  FAIL "));
+    Serial.println(what);
+    if (!ok) s_fail++;
+}
+
+static void print_stats(const isr_stats_t& st)
+{
+    Serial.print(F("  probe n="));
+    Serial.print(st.probe_count);
+    Serial.print(F(" lat_avg="));
+    Serial.print(st.lat_avg_tk);
+    Serial.print(F(" lat_max="));
+    Serial.print(st.lat_max_tk);
+    Serial.print(F(" int1 n="));
+    Serial.print(st.int1_count);
+    Serial.print(F(" dur_max="));
+    Serial.print(st.int1_dur_max_tk);
+    Serial.print(F(" dropped="));
+    Serial.print(dvr_led_dropped_edges());
+    Serial.print(F(" storms="));
+    Serial.println(dvr_led_storm_trips());
+}
+
+// Keep the classifier draining while waiting (as loop() would)
+static void wait_polled(uint32_t ms)
+{
+    const uint32_t t0 = millis();
+    while ((uint32_t)(millis() - t0) < ms)
+        dvr_led_poll(millis());
+}
+
+static void toggle_polled(uint8_t edges, uint32_t every_ms)
+{
+    for (uint8_t i = 0; i < edges; i++)
+    {
+        pd3_toggle();
+        wait_polled(every_ms);
+    }
+}
+
+// ----------------------------------------------------------------------------
+// Phases
+// ----------------------------------------------------------------------------
+static void phase_quiet(void)
+{
+    Serial.println(F("[1] quiet 1 s"));
+    isr_stats_reset();
+    wait_polled(1000);
+
+    isr_stats_t st;
+    isr_stats_get(&st);
+    print_stats(st);
+    check(F("probes 990..1010"), st.probe_count >= 990 && st.probe_count <= 1010);
+    check(F("no INT1"), st.int1_count == 0);
+}
+
+static void phase_slow(void)
+{
+    Serial.println(F("[2] 20 edges @ 50 ms, polled"));
+    const uint16_t d0 = dvr_led_dropped_edges();
+    isr_stats_reset();
+    toggle_polled(20, 50);
+
+    isr_stats_t st;
+    isr_stats_get(&st);
+    print_stats(st);
+    check(F("INT1 +20"), st.int1_count == 20);
+    check(F("no drops"), dvr_led_dropped_edges() == d0);
+    check(F("no storm"), dvr_led_storm_trips() == 0);
+}
+
+static void phase_overflow(void)
+{
+    Serial.println(F("[3] 80 edges @ 5 ms, poll stalled"));
+    wait_polled(200);                      // ring empty before the stall
+    const uint16_t d0 = dvr_led_dropped_edges();
+    isr_stats_reset();
+
+    for (uint8_t i = 0; i < OVERFLOW_EDGES; i++)
+    {
+        pd3_toggle();
+        delay(5);                          // > 3 ms glitch reject, < storm rate
+    }
+
+    isr_stats_t st;
+    isr_stats_get(&st);
+    print_stats(st);
+    check(F("INT1 +80"), st.int1_count == OVERFLOW_EDGES);
+    check(F("dropped +17"), (uint16_t)(dvr_led_dropped_edges() - d0) == (uint16_t)(OVERFLOW_EDGES - RING_SLOTS));
+    check(F("no storm"), dvr_led_storm_trips() == 0);
+
+    wait_polled(200);                      // drain (classifier sees the GAP)
+}
+
+static void phase_storm(void)
+{
+    Serial.println(F("[4] 100 ms @ 10 kHz"));
+    wait_polled(100);                      // let the 20 ms storm window expire
+    const uint16_t trips0 = dvr_led_storm_trips();
+    isr_stats_reset();
+
+    for (uint16_t i = 0; i < 2000; i++)
+    {
+        pd3_toggle();
+        delayMicroseconds(50);
+    }
+    const bool active_during = dvr_led_storm_active();
+
+    isr_stats_t st;
+    isr_stats_get(&st);
+    print_stats(st);
+    check(F("storm active"), active_during);
+    check(F("1 trip"), (uint16_t)(dvr_led_storm_trips() - trips0) == 1);
+    check(F("INT1 masked after 9 entries"), st.int1_count == STORM_ENTRIES);
+
+    const uint32_t t0 = millis();
+    while (dvr_led_storm_active() && (uint32_t)(millis() - t0) < 1500)
+        dvr_led_poll(millis());
+
+    Serial.print(F("  re-armed after ms="));
+    Serial.println(millis() - t0);
+    check(F("INT1 re-armed within 1 s"), !dvr_led_storm_active() && (uint32_t)(millis() - t0) <= 1000);
+}
+
+static void phase_stall(void)
+{
+    Serial.println(F("[5] 10 x 1.5 ms interrupts-off stall in 100 ms"));
+    isr_stats_reset();
+
+    const uint32_t t0 = millis();
+    for (uint8_t i = 0; i < 10; i++)
+    {
+        noInterrupts();
+        delayMicroseconds(STALL_US);
+        interrupts();
+        delayMicroseconds(8500);
+    }
+    const uint32_t el = millis() - t0;
+
+    isr_stats_t st;
+    isr_stats_get(&st);
+    print_stats(st);
+    Serial.print(F("  elapsed ms="));
+    Serial.println(el);
+    check(F("probe kept firing (>= 80)"), st.probe_count >= 80);
+    check(F("lat_max >= stall - period"), st.lat_max_tk >= (uint16_t)((STALL_US - PROBE_US) * 2u));
+}
+
+static void phase_rearm(void)
+{
+    Serial.println(F("[6] 10 edges @ 50 ms after storm"));
+    const uint16_t d0 = dvr_led_dropped_edges();
+    isr_stats_reset();
+    toggle_polled(10, 50);
+
+    isr_stats_t st;
+    isr_stats_get(&st);
+    print_stats(st);
+    check(F("INT1 +10"), st.int1_count == 10);
+    check(F("no new drops"), dvr_led_dropped_edges() == d0);
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    delay(200);
+
+    pins_init();
+    hw_timer_init();
+    isr_stats_init();
+    dvr_led_init();
+
+    // Drive PD3 ourselves (bare board only, see header)
+    digitalWrite(PIN_DVR_STAT, HIGH);
+    pinMode(PIN_DVR_STAT, OUTPUT);
+    wait_polled(100);
+
+    Serial.println(F("SMOKE 8: INT1 edge storm / ISR stats"));
+
+    phase_quiet();
+    phase_slow();
+    phase_overflow();
+    phase_storm();
+    phase_stall();
+    phase_rearm();
+
+    Serial.print(F("SMOKE 8: "));
+    if (s_fail) { Serial.print(s_fail); Serial.println(F(" FAIL")); }
+    else        { Serial.println(F("ALL PASS")); }
+}
+
+void loop()
+{
+    dvr_led_poll(millis());
+}
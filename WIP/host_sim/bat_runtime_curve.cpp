@@ -0,0 +1,77 @@
+// bat_runtime_curve.cpp
+//
+// Fixed-point SoC / recording minutes vs. a floating-point reference
+// (user-047 figures, 28ae2a7). For each pack voltage, bat_runtime is fed the
+// matching open-circuit estimate (12-bit counts) until its EMA settles, then
+// SoC and minutes are compared with the same 21-point 2S LiPo curve in
+// double precision. Also prints the EMA step response (2000 -> 2040 counts).
+//
+//   run.sh bat_runtime_curve
+//
+// SOURCES: src/bat_runtime.cpp
+
+#include "sim.h"
+
+#include <math.h>
+
+#include "bat_runtime.h"
+#include "thresholds.h"
+
+// Pack voltage (mV) -> SoC (%), same points as the PROGMEM curve
+static double ref_pct(double mv)
+{
+    static const double curve[][2] =
+    {
+        { 8400, 100 }, { 8300, 95 }, { 8220, 90 }, { 8160, 85 }, { 8040, 80 },
+        { 7960,  75 }, { 7900, 70 }, { 7820, 65 }, { 7740, 60 }, { 7700, 55 },
+        { 7680,  50 }, { 7640, 45 }, { 7600, 40 }, { 7580, 35 }, { 7540, 30 },
+        { 7500,  25 }, { 7460, 20 }, { 7420, 15 }, { 7380, 10 }, { 7220,  5 },
+        { 6540,   0 },
+    };
+
+    if (mv >= curve[0][0])
+        return 100;
+    for (int i = 1; i < 21; i++)
+    {
+        if (mv >= curve[i][0])
+            return curve[i][1] + (curve[i - 1][1] - curve[i][1]) * (mv - curve[i][0])
+                                     / (curve[i - 1][0] - curve[i][0]);
+    }
+    return 0;
+}
+
+// 12-bit counts (ADC_OS scale) <-> pack mV through the 101k/33k divider, 5.00 V AVCC
+static double counts_to_mv(double c) { return c / 4.0 / 1023.0 * 5000.0 * 101.0 / 33.0; }
+static double mv_to_counts(double mv) { return mv * 4.0 * 1023.0 * 33.0 / (5000.0 * 101.0); }
+
+int main()
+{
+    const double lock_pct = ref_pct(counts_to_mv(ADC_OS(ADC_LOCKOUT_ENTER)));
+    printf("SoC at ADC_LOCKOUT_ENTER: reference %.2f %%\n", lock_pct);
+
+    const double mvs[] = { 8450, 8100, 7700, 7500, 7400, 7300, 7100, 6900, 6806, 6700 };
+    for (double mv : mvs)
+    {
+        bat_runtime_init();
+        const uint16_t est = (uint16_t)(mv_to_counts(mv) + 0.5);
+        for (int i = 0; i < 60; i++)
+            bat_runtime_update(est);
+
+        const double pct = ref_pct(mv);
+        const double min = (pct > lock_pct ? pct - lock_pct : 0) / 100.0
+                         * BAT_CAPACITY_MAH * 60.0 / BAT_I_DVR_REC_MA;
+        printf("  %5.0f mV  est %4u  SoC %4u permille (ref %6.1f)  minutes %3u (ref %5.1f)\n",
+               mv, est, bat_runtime_soc_permille(), pct * 10.0, bat_runtime_rec_minutes(), min);
+    }
+
+    printf("step 2000 -> 2040 counts:\n");
+    bat_runtime_init();
+    bat_runtime_update(2000);
+    for (int i = 1; i <= 10; i++)
+    {
+        bat_runtime_update(2040);
+        if (i % 2 == 0)
+            printf("  after %2d samples  SoC %4u permille\n", i, bat_runtime_soc_permille());
+    }
+    return 0;
+}
@@ -0,0 +1,161 @@
+// controller_fsm_reconcile.cpp
+//
+// FSM belief vs. the DVR's own state changes (user-042 figures, 0790efd).
+// Real FSM, status layer, confirmation and reconcile; the DVR is a model
+// (off / idle / recording) that reports its LED pattern 1.5 s after each
+// change, as EV_DVR_LED_PATTERN_CHANGED. Presses come from the action queue.
+// Steps 10 ms. Script:
+//   user taps twice (power on, record), then the DVR reboots by itself while
+//   recording (off 4 s, then idle), then its own button stops the recording,
+//   then the user taps once more.
+//
+//   run.sh controller_fsm_reconcile
+//   ROOT=<checkout of 0790efd^> run.sh controller_fsm_reconcile
+//
+// SOURCES: src/controller_fsm.cpp src/ui_policy.cpp src/action_queue.cpp src/event_queue.cpp src/drv_dvr_status.cpp src/dvr_confirm.cpp src/dvr_reconcile.cpp
+
+#include "sim.h"
+
+#include "event_queue.h"
+#include "action_queue.h"
+#include "controller_fsm.h"
+#include "drv_dvr_status.h"
+#include "dvr_led.h"
+
+// -----------------------------------------------------------------------------
+// LED layer stand-ins: the status layer only reads these for the card-error
+// bounds, dvr_confirm for its edge check. Not every tree calls all of them.
+// -----------------------------------------------------------------------------
+static dvr_led_pattern_t s_led   = DVR_LED_OFF;
+static uint16_t          s_edges = 0;
+
+dvr_led_pattern_t dvr_led_get_pattern(void) { return s_led; }
+uint8_t           dvr_led_blink_edges(void) { return 0; }
+uint16_t          dvr_led_edge_count(void) { return s_edges; }
+
+bool drv_dvr_led_fast_burst(uint32_t, uint8_t*, uint32_t*) { return false; }
+void drv_fuel_gauge_set_fsm_state(controller_state_t) {}
+
+// -----------------------------------------------------------------------------
+// DVR model
+// -----------------------------------------------------------------------------
+enum dvr_model_t { DVR_M_OFF, DVR_M_IDLE, DVR_M_REC };
+
+static dvr_model_t       s_dvr      = DVR_M_OFF;
+static uint32_t          s_led_due  = 0;
+static dvr_led_pattern_t s_led_next = DVR_LED_OFF;
+static uint32_t          s_now      = 1000;
+static int               s_presses  = 0;
+
+static void dvr_set(dvr_model_t s)
+{
+    s_dvr      = s;
+    s_edges   += 3;
+    s_led_next = (s == DVR_M_OFF) ? DVR_LED_OFF : (s == DVR_M_IDLE) ? DVR_LED_SOLID : DVR_LED_SLOW_BLINK;
+    s_led_due  = s_now + 1500;
+}
+
+static void step(void)
+{
+    if (s_led_due && s_now >= s_led_due)
+    {
+        s_led_due = 0;
+        s_led     = s_led_next;
+
+        event_t e = {};
+        e.t_ms    = s_now;
+        e.id      = EV_DVR_LED_PATTERN_CHANGED;
+        e.arg0    = s_led;
+        eventq_push(&e);
+    }
+
+    drv_dvr_status_poll(s_now);
+    controller_fsm_poll(s_now);
+
+    action_t a;
+    while (actionq_pop(&a))
+    {
+        if (a.id == ACT_DVR_PRESS_SHORT)
+        {
+            s_presses++;
+            if (s_dvr == DVR_M_IDLE)
+                dvr_set(DVR_M_REC);
+            else if (s_dvr == DVR_M_REC)
+                dvr_set(DVR_M_IDLE);
+        }
+        else if (a.id == ACT_DVR_PRESS_LONG)
+        {
+            s_presses++;
+            dvr_set(s_dvr == DVR_M_OFF ? DVR_M_IDLE : DVR_M_OFF);
+        }
+    }
+}
+
+static void run_ms(uint32_t ms)
+{
+    for (const uint32_t end = s_now + ms; s_now < end; s_now += 10)
+        step();
+}
+
+static void user_tap(void)
+{
+    event_t e = {};
+    e.t_ms    = s_now;
+    e.id      = EV_BTN_SHORT_PRESS;
+    eventq_push(&e);
+}
+
+static const char* dvr_name(dvr_model_t s)
+{
+    static const char* const names[] = { "off", "idle", "recording" };
+    return names[s];
+}
+
+static const char* fsm_name(controller_state_t s)
+{
+    static const char* const names[] = { "OFF", "BOOTING", "IDLE", "RECORDING", "LOW_BAT", "ERROR", "LOCKOUT" };
+    return ((unsigned)s < 7) ? names[s] : "?";
+}
+
+int main()
+{
+    eventq_init();
+    actionq_init();
+    drv_dvr_status_init();
+    controller_fsm_init();
+
+    run_ms(1000);
+    user_tap();
+    run_ms(10000);
+    user_tap();
+    run_ms(10000);
+    printf("setup:          DVR %-9s FSM %-9s presses %d\n",
+           dvr_name(s_dvr), fsm_name(controller_fsm_state()), s_presses);
+
+    // DVR reboots by itself: off for 4 s, then idle
+    dvr_set(DVR_M_OFF);
+    run_ms(4000);
+    dvr_set(DVR_M_IDLE);
+    const uint32_t t0 = s_now;
+    int            p0 = s_presses;
+    for (int i = 0; i < 6000 && s_dvr != DVR_M_REC; i++)
+        run_ms(10);
+    if (s_dvr == DVR_M_REC)
+        printf("DVR reboot:     recording again %lu ms after it is back, automatic presses %d, FSM %s\n",
+               (unsigned long)(s_now - t0), s_presses - p0, fsm_name(controller_fsm_state()));
+    else
+        printf("DVR reboot:     not recording after 60 s, automatic presses %d, FSM %s\n",
+               s_presses - p0, fsm_name(controller_fsm_state()));
+
+    // The DVR's own button stops the recording
+    dvr_set(DVR_M_IDLE);
+    run_ms(8000);
+    printf("physical stop:  DVR %-9s FSM %s\n", dvr_name(s_dvr), fsm_name(controller_fsm_state()));
+
+    p0 = s_presses;
+    user_tap();
+    run_ms(8000);
+    printf("next user tap:  DVR %-9s FSM %-9s presses %d\n",
+           dvr_name(s_dvr), fsm_name(controller_fsm_state()), s_presses - p0);
+    return 0;
+}
@@ -0,0 +1,79 @@
+// drv_dvr_led_report.cpp
+//
+// DVR LED bridge report timing (user-039 figures, a660682).
+// LED solid 3 s, then fast blink (100/100 ms), real classifier and bridge.
+// drv_dvr_led_poll() runs every P ms; the classifier itself is sampled every
+// 100 us to find when it decided. For the first reports: how long after the
+// classifier decided the event was emitted (hold-off), and the error of the
+// event's t_ms against that decision time.
+//
+//   run.sh drv_dvr_led_report
+//
+// SOURCES: src/dvr_led.cpp src/hw_timer.cpp src/led_cal.cpp src/crc8.cpp src/drv_dvr_led.cpp src/event_queue.cpp
+
+#include "sim.h"
+
+#include "dvr_led.h"
+#include "drv_dvr_led.h"
+#include "event_queue.h"
+
+extern "C" void INT1_vect(void);
+
+static void trial(uint32_t period_ms)
+{
+    uint64_t t = SIM_T0_TK;
+    sim_set_time(t);
+    sim_led_level(0);
+    eventq_init();
+    drv_dvr_led_init();
+
+    int      off       = 0;
+    uint64_t next_edge = t + 3000 * SIM_TK_PER_MS;
+    uint64_t next_poll = t;
+    int      prev      = dvr_led_get_pattern();
+    uint32_t dec_ms    = 0;
+    int      n         = 0;
+
+    for (; t < SIM_T0_TK + 8000 * SIM_TK_PER_MS; t += 200)
+    {
+        sim_set_time(t);
+
+        if (t >= next_edge)
+        {
+            off ^= 1;
+            sim_led_level(off);
+            INT1_vect();
+            next_edge = t + 100 * SIM_TK_PER_MS;
+        }
+
+        const int p = dvr_led_get_pattern();
+        if (p != prev)
+        {
+            prev   = p;
+            dec_ms = millis();
+        }
+
+        if (t >= next_poll)
+        {
+            next_poll = t + period_ms * SIM_TK_PER_MS;
+            drv_dvr_led_poll(millis());
+
+            event_t e;
+            while (eventq_pop(&e))
+            {
+                if (n++ < 3)
+                    printf("  loop %3lu ms  %-5s  hold-off %4lu ms  t_ms error %ld ms\n",
+                           (unsigned long)period_ms, sim_pattern_name(e.arg0),
+                           (unsigned long)(millis() - dec_ms), (long)(e.t_ms - dec_ms));
+            }
+        }
+    }
+}
+
+int main()
+{
+    const uint32_t periods[] = { 1, 5, 20, 50, 100 };
+    for (uint32_t p : periods)
+        trial(p);
+    return 0;
+}
@@ -0,0 +1,102 @@
+// drv_dvr_led_spacing.cpp
+//
+// DVR LED bridge against a scripted classifier (user-039 review fix,
+// 93eafa5). The classifier functions the bridge calls are replaced here, so
+// decision times and confidence are set exactly:
+//   A: SOLID decided at t, reported; FAST appears 32 ms later but back-dated
+//      20 ms (late ring drain). The gap between the two events' t_ms must
+//      still be at least the bridge's T_LED_BRIDGE_GAP_MS.
+//   B: SLOW held back by low confidence for 40 min (past the 35.8 min
+//      Timer1 wrap), then confident. The event's t_ms must be the decision.
+//
+//   run.sh drv_dvr_led_spacing
+//
+// SOURCES: src/hw_timer.cpp src/drv_dvr_led.cpp src/event_queue.cpp
+
+#include "sim.h"
+
+#include "dvr_led.h"
+#include "drv_dvr_led.h"
+#include "event_queue.h"
+#include "timings.h"
+
+// -----------------------------------------------------------------------------
+// Scripted classifier
+// -----------------------------------------------------------------------------
+static dvr_led_pattern_t s_pat   = DVR_LED_UNKNOWN;
+static uint32_t          s_since = 0;     // Timer1 ticks
+static uint8_t           s_conf  = 255;
+
+void              dvr_led_init(void) {}
+void              dvr_led_poll(uint32_t) {}
+dvr_led_pattern_t dvr_led_get_pattern(void) { return s_pat; }
+uint8_t           dvr_led_get_confidence(void) { return s_conf; }
+uint8_t           dvr_led_blink_edges(void) { return 0; }
+
+dvr_led_pattern_t dvr_led_get_pattern_since(uint32_t* since_tk)
+{
+    *since_tk = s_since;
+    return s_pat;
+}
+
+static void decide(dvr_led_pattern_t p)
+{
+    s_pat   = p;
+    s_since = (uint32_t)g_sim_tk;
+}
+
+// -----------------------------------------------------------------------------
+static uint64_t s_t;
+static uint32_t s_last_t_ms;
+static int      s_events;
+
+static void step(uint64_t tk)
+{
+    s_t += tk;
+    sim_set_time(s_t);
+    drv_dvr_led_poll(millis());
+
+    event_t e;
+    while (eventq_pop(&e))
+    {
+        printf("  %-5s t_ms %10lu  (polled at %10lu)", sim_pattern_name(e.arg0),
+               (unsigned long)e.t_ms, (unsigned long)millis());
+        if (s_events)
+            printf("  dt %ld ms", (long)(e.t_ms - s_last_t_ms));
+        printf("\n");
+        s_last_t_ms = e.t_ms;
+        s_events++;
+    }
+}
+
+int main()
+{
+    s_t = 2 * SIM_T0_TK;
+    sim_set_time(s_t);
+    eventq_init();
+    drv_dvr_led_init();
+
+    printf("A: SOLID, then FAST 32 ms later back-dated by 20 ms (gap %u ms)\n",
+           (unsigned)T_LED_BRIDGE_GAP_MS);
+    decide(DVR_LED_SOLID);
+    for (int i = 0; i < 200; i++)
+    {
+        step(SIM_TK_PER_MS);
+        if (i == 31)
+        {
+            decide(DVR_LED_FAST_BLINK);
+            s_since -= 20 * SIM_TK_PER_MS;
+        }
+    }
+
+    printf("B: SLOW held back by low confidence for 40 min, then confident\n");
+    s_conf = 0;
+    decide(DVR_LED_SLOW_BLINK);
+    const uint32_t dec_ms = millis();
+    for (uint64_t ms = 0; ms < 40ull * 60 * 1000; ms += 10)
+        step(10 * SIM_TK_PER_MS);
+    s_conf = 255;
+    step(SIM_TK_PER_MS);
+    printf("  decided at t_ms %10lu\n", (unsigned long)dec_ms);
+    return 0;
+}
@@ -0,0 +1,105 @@
+// drv_dvr_status_card.cpp
+//
+// SD-card error vs. shutdown burst (user-040 figures, 6609f0e / f04296d).
+// LED solid 3 s, then fast blink (half period h ms), either forever (missing
+// card, stuck FAST) or for a bounded burst that ends with the LED off (DVR
+// shutdown). Real classifier, bridge and status layer, polled every 1 ms.
+// Prints the time from the first fast edge to EV_DVR_ERROR.
+//
+//   run.sh drv_dvr_status_card
+//
+// The trial's FSM state is only read by trees between 6609f0e and
+// f04296d^, where drv_dvr_status asked controller_fsm_state(); the current
+// module is purely LED-driven and ignores it:
+//   ROOT=<checkout of 6609f0e^ or f04296d^> run.sh drv_dvr_status_card
+//
+// SOURCES: src/dvr_led.cpp src/hw_timer.cpp src/led_cal.cpp src/crc8.cpp src/drv_dvr_led.cpp src/drv_dvr_status.cpp src/event_queue.cpp
+
+#include "sim.h"
+
+#include "dvr_led.h"
+#include "drv_dvr_led.h"
+#include "drv_dvr_status.h"
+#include "controller_fsm.h"
+#include "event_queue.h"
+
+extern "C" void INT1_vect(void);
+
+static controller_state_t s_fsm_state;
+
+controller_state_t controller_fsm_state(void)
+{
+    return s_fsm_state;
+}
+
+// burst_ms = 0: fast blink until the end of the run
+static void trial(const char* name, controller_state_t st, uint32_t half_ms, uint32_t burst_ms)
+{
+    uint64_t t = SIM_T0_TK;
+    sim_set_time(t);
+    sim_led_level(0);
+    s_fsm_state = st;
+    eventq_init();
+    drv_dvr_led_init();
+    drv_dvr_status_init();
+
+    const uint64_t t_fast    = t + 3000 * SIM_TK_PER_MS;
+    const uint64_t stop      = burst_ms ? t_fast + burst_ms * SIM_TK_PER_MS : ~0ull;
+    uint64_t       next_edge = t_fast;
+    int            off       = 0;
+    long           err_ms    = -1;
+
+    for (; t < SIM_T0_TK + 20000 * SIM_TK_PER_MS; t += 200)
+    {
+        sim_set_time(t);
+
+        if (t >= next_edge && t < stop)
+        {
+            off ^= 1;
+            sim_led_level(off);
+            INT1_vect();
+            next_edge = t + half_ms * SIM_TK_PER_MS;
+        }
+        else if (t >= stop && !off)
+        {
+            off = 1;
+            sim_led_level(off);
+            INT1_vect();
+        }
+
+        if ((t % SIM_TK_PER_MS) == 0)
+        {
+            drv_dvr_led_poll(millis());
+            drv_dvr_status_poll(millis());
+
+            event_t e;
+            while (eventq_pop(&e))
+            {
+                if (e.id == EV_DVR_ERROR && err_ms < 0)
+                    err_ms = (long)((t - t_fast) / SIM_TK_PER_MS);
+            }
+        }
+    }
+
+    if (err_ms < 0)
+        printf("%-44s no card error\n", name);
+    else
+        printf("%-44s card error after %5ld ms of fast blink\n", name, err_ms);
+}
+
+int main()
+{
+    trial("missing card at boot (BOOTING), 100/100",    STATE_BOOTING,   100, 0);
+    trial("missing card while IDLE, 60/60",             STATE_IDLE,       60, 0);
+    trial("stuck FAST after commanded off, 100/100",    STATE_OFF,       100, 0);
+    trial("stuck FAST after commanded off, 150/150",    STATE_OFF,       150, 0);
+    trial("stuck FAST after commanded off, 60/60",      STATE_OFF,        60, 0);
+    trial("commanded shutdown burst 1.5s 100/100",      STATE_OFF,       100, 1500);
+    trial("commanded shutdown burst 2.0s 100/100",      STATE_OFF,       100, 2000);
+    trial("commanded shutdown burst 1.5s 60/60",        STATE_OFF,        60, 1500);
+    trial("commanded shutdown burst 1.5s 150/150",      STATE_OFF,       150, 1500);
+    trial("DVR button shutdown from IDLE 1.5s 100/100", STATE_IDLE,      100, 1500);
+    trial("DVR button shutdown from REC 1.5s 60/60",    STATE_RECORDING,  60, 1500);
+    trial("DVR low-V cutoff from REC 1.5s 150/150",     STATE_RECORDING, 150, 1500);
+    return 0;
+}
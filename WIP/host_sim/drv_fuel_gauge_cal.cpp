@@ -0,0 +1,130 @@
+// drv_fuel_gauge_cal.cpp
+//
+// Per-unit battery calibration and bandgap ratio correction (user-048 /
+// user-049 figures, e141e29 / 26a9980). The real gauge, calibration record
+// and EEPROM stand-in; hw_adc is replaced by a unit model that hands the
+// gauge one battery sample and one bandgap reading per poll:
+//   pin mV = (pack mV x UNIT_GAIN + UNIT_OFF_MV) x 33 / 101, AVCC and the
+//   bandgap voltage set per run, 12-bit counts (4092 full scale).
+// The gauge sees the DVR off (REST load, no sag compensation). Reads are
+// converted back to pack mV with the nominal divider.
+//
+//   run.sh drv_fuel_gauge_cal
+//
+// SOURCES: src/drv_fuel_gauge.cpp src/bat_cal.cpp src/bat_runtime.cpp src/crc8.cpp src/event_queue.cpp
+
+#include "sim.h"
+
+#include <math.h>
+
+#include "drv_fuel_gauge.h"
+#include "drv_dvr_status.h"
+#include "controller_fsm.h"
+#include "hw_adc.h"
+#include "thresholds.h"
+
+// -----------------------------------------------------------------------------
+// hw_adc / status stand-ins (not every tree calls all of them)
+// -----------------------------------------------------------------------------
+static uint16_t s_raw      = 0;
+static uint16_t s_bg       = HW_ADC_BG_NOMINAL;
+static bool     s_have     = false;
+static uint16_t s_trip_lvl = 0;
+
+void     hw_adc_init(void) {}
+bool     hw_adc_take(uint16_t* out) { *out = s_raw; return s_have; }
+uint16_t hw_adc_bandgap(void) { return s_bg; }
+void     hw_adc_trip_arm(uint16_t level, uint8_t, hw_adc_trip_fn) { s_trip_lvl = level; }
+void     hw_adc_trip_set_level(uint16_t level) { s_trip_lvl = level; }
+bool     hw_adc_trip_disarm(void) { return true; }
+
+controller_state_t controller_fsm_state(void) { return STATE_OFF; }
+bool               drv_dvr_status_recording_assumed(void) { return false; }
+dvr_led_pattern_t  drv_dvr_status_last_led_pattern(void) { return DVR_LED_OFF; }
+
+// -----------------------------------------------------------------------------
+// Unit model
+// -----------------------------------------------------------------------------
+static double   s_gain   = 1.0;
+static double   s_off_mv = 0;
+static double   s_vcc    = 5.0;
+static double   s_vbg    = 1.1;
+static uint32_t s_now    = 0;
+
+static void sample(double pack_mv)
+{
+    const double pin = (pack_mv * s_gain + s_off_mv) / 1000.0 * 33.0 / 101.0;
+    s_raw  = (uint16_t)lround(pin / s_vcc * 4092);
+    s_bg   = (uint16_t)lround(s_vbg / s_vcc * 4092);
+    s_have = true;
+    s_now += 1000;
+    drv_fuel_gauge_poll(s_now);
+}
+
+static double read_mv(void)
+{
+    return drv_fuel_gauge_last_adc() * 505000.0 / 135036.0;
+}
+
+static void sweep(const char* name)
+{
+    static const double pts[] = { 6800, 7400, 8200 };
+
+    printf("  %-12s", name);
+    for (double p : pts)
+    {
+        sample(p);
+        printf("  %4.0f -> %4.0f", p, read_mv());
+    }
+    printf("\n");
+}
+
+int main()
+{
+    // e141e29: nominal unit, AVCC sagged to 4.75 V, pack at the lockout point
+    printf("bandgap correction, nominal unit, AVCC 4.75 V, pack 6810 mV:\n");
+    drv_fuel_gauge_init();
+    s_vcc = 4.75;
+    sample(6810);
+    printf("  reading %u counts, AVCC %u mV (ADC_OS(ADC_LOCKOUT_ENTER) = %u)\n",
+           drv_fuel_gauge_last_adc(), drv_fuel_gauge_vcc_mv(), (unsigned)ADC_OS(ADC_LOCKOUT_ENTER));
+
+    // 26a9980: unit reading high, bandgap 1.08 V
+    printf("calibration, unit gain +2.6 %%, offset +35 mV, bandgap 1.08 V:\n");
+    s_vcc    = 5.0;
+    s_gain   = 1.026;
+    s_off_mv = 35;
+    s_vbg    = 1.08;
+    drv_fuel_gauge_cal_clear();
+    drv_fuel_gauge_init();
+    sweep("uncalibrated");
+
+    sample(7000);
+    printf("  point at 7000 mV: %d\n", drv_fuel_gauge_cal_point(7000));
+    sweep("1 point");
+
+    sample(8200);
+    printf("  point at 8200 mV: %d\n", drv_fuel_gauge_cal_point(8200));
+    sweep("2 points");
+
+    bat_cal_t c;
+    drv_fuel_gauge_cal_get(&c);
+    printf("  gain_q14 %u  offset %d\n", c.gain_q14, c.offset);
+
+    const double vccs[] = { 4.6, 5.0, 5.3 };
+    for (double v : vccs)
+    {
+        char name[16];
+        s_vcc = v;
+        snprintf(name, sizeof name, "AVCC %.1f V", v);
+        sweep(name);
+    }
+    s_vcc = 5.0;
+
+    drv_fuel_gauge_init();
+    bat_cal_t r;
+    drv_fuel_gauge_cal_get(&r);
+    printf("  reloaded from EEPROM: gain_q14 %u  offset %d  (%s)\n", r.gain_q14, r.offset,
+           (r.gain_q14 == c.gain_q14 && r.offset == c.offset) ? "intact" : "DIFFERS");
+    return 0;
+}
@@ -0,0 +1,100 @@
+// drv_fuel_gauge_load.cpp
+//
+// Lockout point under load (user-046 figures, 9e1c57a / 48900b2). The real
+// gauge, with hw_adc replaced by a nominal unit (exact divider, AVCC 5.00 V,
+// bandgap 1.1 V) and the FSM / DVR status inputs scripted. The pack's
+// open-circuit voltage falls 1 mV per gauge sample from 7.20 V; the terminal
+// reads OCV - I x R_int of the load the DVR really draws. Only the polled
+// path is exercised (the ISR trip is not simulated). Prints the OCV and
+// terminal voltage at EV_BAT_LOCKOUT_ENTER.
+//   recording  : DVR recording (600 mA), FSM RECORDING, LED slow blink
+//   DVR crashed: DVR off (no load), FSM still RECORDING, LED off
+//
+//   run.sh drv_fuel_gauge_load
+//   ROOT=<checkout of 9e1c57a^> run.sh drv_fuel_gauge_load   (no load model)
+//   ROOT=<checkout of 48900b2^> run.sh drv_fuel_gauge_load   (FSM first)
+//
+// SOURCES: src/drv_fuel_gauge.cpp src/bat_cal.cpp src/bat_runtime.cpp src/crc8.cpp src/event_queue.cpp
+
+#include "sim.h"
+
+#include <math.h>
+
+#include "drv_fuel_gauge.h"
+#include "drv_dvr_status.h"
+#include "controller_fsm.h"
+#include "event_queue.h"
+#include "hw_adc.h"
+#include "thresholds.h"
+
+// The pack as modelled (fixed here: trees before 9e1c57a have no load model)
+static const double PACK_R_INT_MOHM = 250;
+static const double DVR_REC_MA      = 600;
+
+// -----------------------------------------------------------------------------
+// hw_adc / FSM / status stand-ins (not every tree calls all of them)
+// -----------------------------------------------------------------------------
+static uint16_t           s_raw  = 0;
+static bool               s_have = false;
+static controller_state_t s_fsm  = STATE_OFF;
+static dvr_led_pattern_t  s_led  = DVR_LED_OFF;
+static bool               s_rec  = false;
+
+void     hw_adc_init(void) {}
+bool     hw_adc_take(uint16_t* out) { *out = s_raw; return s_have; }
+uint16_t hw_adc_bandgap(void) { return 900; }   // 1.1 V at AVCC 5.00 V
+void     hw_adc_trip_arm(uint16_t, uint8_t, hw_adc_trip_fn) {}
+void     hw_adc_trip_set_level(uint16_t) {}
+bool     hw_adc_trip_disarm(void) { return true; }
+
+controller_state_t controller_fsm_state(void) { return s_fsm; }
+bool               drv_dvr_status_recording_assumed(void) { return s_rec; }
+dvr_led_pattern_t  drv_dvr_status_last_led_pattern(void) { return s_led; }
+
+// -----------------------------------------------------------------------------
+static void run(const char* name, double load_ma)
+{
+    const double sag_mv = load_ma * PACK_R_INT_MOHM / 1000.0;
+    uint32_t     now    = 0;
+
+    eventq_init();
+    drv_fuel_gauge_init();
+
+    for (double ocv = 7200; ocv > 6400; ocv -= 1)
+    {
+        const double term = ocv - sag_mv;
+        s_raw  = (uint16_t)lround(term * 135036.0 / 505000.0);
+        s_have = true;
+        now   += 1000;
+        drv_fuel_gauge_poll(now);
+
+        event_t e;
+        while (eventq_pop(&e))
+        {
+            if (e.id == EV_BAT_LOCKOUT_ENTER)
+            {
+                printf("  %-12s lockout at %4.0f mV open-circuit (terminal %4.0f mV)\n", name, ocv, term);
+                return;
+            }
+        }
+    }
+    printf("  %-12s no lockout\n", name);
+}
+
+int main()
+{
+    printf("ADC_LOCKOUT_ENTER %u = %.0f mV at the pack; recording sag %.0f mV\n",
+           (unsigned)ADC_LOCKOUT_ENTER, ADC_OS(ADC_LOCKOUT_ENTER) * 505000.0 / 135036.0,
+           DVR_REC_MA * PACK_R_INT_MOHM / 1000.0);
+
+    s_fsm = STATE_RECORDING;
+    s_led = DVR_LED_SLOW_BLINK;
+    s_rec = true;
+    run("recording", DVR_REC_MA);
+
+    s_fsm = STATE_RECORDING;
+    s_led = DVR_LED_OFF;
+    s_rec = false;
+    run("DVR crashed", 0);
+    return 0;
+}
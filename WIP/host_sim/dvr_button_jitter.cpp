@@ -0,0 +1,155 @@
+// dvr_button_jitter.cpp
+//
+// Button press-duration accuracy under loop jitter (user-050 figures,
+// db3c66a). 200 presses of 60-1200 ms on PD2 (active low), each edge
+// followed by 0-4 bounce pulses, the line stepped every 50 us. INT0 runs on
+// every change while EIMSK enables it; button_poll() runs every 1 ms plus a
+// random 0..J-1 ms of loop jitter. Prints the short-press duration error
+// (event arg0 against the true hold) and presses that got the wrong event.
+//
+//   run.sh dvr_button_jitter
+//   ROOT=<checkout of db3c66a^> run.sh dvr_button_jitter    (no INT0 yet)
+//
+// SOURCES: src/dvr_button.cpp src/hw_timer.cpp
+
+#include "sim.h"
+
+#include <math.h>
+
+#include "dvr_button.h"
+#include "event_queue.h"
+
+// Trees before db3c66a have no INT0 handler; the weak one stands in
+extern "C" __attribute__((weak)) void INT0_vect(void) {}
+
+// -----------------------------------------------------------------------------
+// Event capture (dvr_button only pushes)
+// -----------------------------------------------------------------------------
+static const int EV_MAX = 4096;
+
+static int      s_nev;
+static uint16_t s_ev_arg[EV_MAX];
+static int      s_ev_id[EV_MAX];
+
+bool eventq_push(const event_t* e)
+{
+    if (s_nev < EV_MAX)
+    {
+        s_ev_arg[s_nev] = e->arg0;
+        s_ev_id[s_nev]  = e->id;
+    }
+    s_nev++;
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+static void pin(int level)
+{
+    const int old = (PIND & _BV(PD2)) ? 1 : 0;
+    PIND = level ? (uint8_t)(PIND | _BV(PD2)) : (uint8_t)(PIND & ~_BV(PD2));
+    if (old != level && (EIMSK & _BV(INT0)))
+        INT0_vect();
+}
+
+struct edge_t
+{
+    uint64_t t;
+    int      level;
+};
+
+static void run(int jitter_ms)
+{
+    srand(1);
+    s_nev = 0;
+    PIND |= _BV(PD2);
+    sim_set_time(1000);
+    hw_timer_init();
+    sim_set_time(1000);
+    button_init();
+    EIFR = 0;
+
+    double   err_sum   = 0;
+    double   err_max   = 0;
+    int      n         = 0;
+    int      wrong     = 0;
+    uint64_t t         = 100 * SIM_TK_PER_MS;
+    uint64_t next_poll = t;
+
+    for (int p = 0; p < 200; p++)
+    {
+        const int      dur    = 60 + rand() % 1140;
+        const uint64_t t_down = t + SIM_TK_PER_MS * (200 + rand() % 300);
+        const uint64_t t_up   = t_down + SIM_TK_PER_MS * dur;
+
+        edge_t   ev[40];
+        int      ne = 0;
+        uint64_t tb = t_down;
+        int      nb = rand() % 5;
+        ev[ne++] = { t_down, 0 };
+        for (int i = 0; i < nb; i++)
+        {
+            tb += SIM_TK_PER_MS * (rand() % 2 + 1) / 2 + 500;
+            ev[ne++] = { tb, 1 };
+            tb += 700;
+            ev[ne++] = { tb, 0 };
+        }
+        nb = rand() % 5;
+        tb = t_up;
+        ev[ne++] = { t_up, 1 };
+        for (int i = 0; i < nb; i++)
+        {
+            tb += 1500;
+            ev[ne++] = { tb, 0 };
+            tb += 700;
+            ev[ne++] = { tb, 1 };
+        }
+
+        const int      e0  = s_nev;
+        const uint64_t end = t_up + 100 * SIM_TK_PER_MS;
+        int            ei  = 0;
+        for (uint64_t now = t; now < end; now += 100)
+        {
+            sim_set_time(now);
+            while (ei < ne && ev[ei].t <= now)
+            {
+                pin(ev[ei].level);
+                ei++;
+            }
+            if (now >= next_poll)
+            {
+                button_poll((uint32_t)(now / SIM_TK_PER_MS));
+                next_poll = now + SIM_TK_PER_MS * (1 + (jitter_ms ? rand() % jitter_ms : 0));
+            }
+        }
+        t = end;
+
+        const int want = (dur >= 500) ? EV_BTN_LONG_PRESS : EV_BTN_SHORT_PRESS;
+        bool      got  = false;
+        for (int k = e0; k < s_nev && k < EV_MAX; k++)
+        {
+            if (s_ev_id[k] != want)
+                continue;
+            got = true;
+            if (want == EV_BTN_SHORT_PRESS)
+            {
+                const double e = fabs((double)s_ev_arg[k] - dur);
+                err_sum += e;
+                if (e > err_max)
+                    err_max = e;
+                n++;
+            }
+        }
+        if (!got)
+            wrong++;
+    }
+
+    printf("jitter <= %2d ms: short-press |error| avg %5.2f ms  max %3.0f ms  (n=%d)  wrong event %d  events %d\n",
+           jitter_ms, n ? err_sum / n : 0, err_max, n, wrong, s_nev);
+}
+
+int main()
+{
+    run(10);
+    run(30);
+    return 0;
+}
@@ -0,0 +1,112 @@
+// dvr_confirm_retry.cpp
+//
+// DVR gesture confirmation and re-press (user-041 figures, c3fd4d0 /
+// f6aac6d). dvr_confirm against a DVR model that misses the first N presses;
+// the LED functions it observes are replaced here. Time steps 10 ms.
+//   REC_START from a solid LED: first LED edge 1000 ms after a registered
+//     press, one per second after that, SLOW reported 2600 ms after it.
+//   REC_STOP during a slow blink that keeps making edges: the classifier
+//     sees the blink end 2600 ms after a registered press, SOLID is
+//     reported at 3000 ms.
+//
+//   run.sh dvr_confirm_retry
+//
+// SOURCES: src/dvr_confirm.cpp
+
+#include "sim.h"
+
+#include "dvr_confirm.h"
+#include "dvr_led.h"
+#include "drv_dvr_status.h"
+
+// -----------------------------------------------------------------------------
+// DVR / LED model
+// -----------------------------------------------------------------------------
+static bool     s_stop;      // REC_STOP scenario (LED blinking when issued)
+static uint32_t s_now;
+static bool     s_reg;       // DVR registered a press
+static uint32_t s_reg_ms;
+
+static bool blink_ended(void)
+{
+    return s_reg && s_now >= s_reg_ms + 2600;
+}
+
+dvr_led_pattern_t drv_dvr_status_last_led_pattern(void)
+{
+    if (s_stop)
+        return (s_reg && s_now >= s_reg_ms + 3000) ? DVR_LED_SOLID : DVR_LED_SLOW_BLINK;
+    return blink_ended() ? DVR_LED_SLOW_BLINK : DVR_LED_SOLID;
+}
+
+dvr_led_pattern_t dvr_led_get_pattern(void)
+{
+    if (s_stop)
+        return blink_ended() ? DVR_LED_UNKNOWN : DVR_LED_SLOW_BLINK;
+    return drv_dvr_status_last_led_pattern();
+}
+
+uint16_t dvr_led_edge_count(void)
+{
+    if (s_stop)
+        return (uint16_t)(100 + (blink_ended() ? s_reg_ms + 2600 : s_now) / 1000);
+    return (s_reg && s_now >= s_reg_ms + 1000) ? (uint16_t)((s_now - s_reg_ms) / 1000) : 0;
+}
+
+// -----------------------------------------------------------------------------
+static void trial(dvr_gesture_t g, int missed)
+{
+    s_stop = (g == DVR_GEST_REC_STOP);
+    s_reg  = false;
+    dvr_confirm_init();
+
+    const dvr_led_pattern_t want    = s_stop ? DVR_LED_SOLID : DVR_LED_SLOW_BLINK;
+    int                     presses = 0;
+    uint32_t                done    = 0;
+
+    for (s_now = 0; s_now < 60000; s_now += 10)
+    {
+        dvr_gesture_t press = g;
+        if (s_now == 0)
+            dvr_confirm_start(0, g);
+        else
+            press = dvr_confirm_poll(s_now);
+
+        if (press != DVR_GEST_NONE)
+        {
+            presses++;
+            printf("    press %d at %5lu ms%s\n", presses, (unsigned long)s_now,
+                   presses > missed ? "" : " (missed by DVR)");
+            if (presses > missed && !s_reg)
+            {
+                s_reg    = true;
+                s_reg_ms = s_now;
+            }
+        }
+
+        if (dvr_confirm_pending() == DVR_GEST_NONE)
+        {
+            done = s_now;
+            break;
+        }
+    }
+
+    dvr_confirm_stats_t st;
+    dvr_confirm_get_stats(&st);
+    printf("  %s missed=%d: %s at %5lu ms  (retries=%u confirmed=%u failed=%u)\n",
+           s_stop ? "REC_STOP " : "REC_START", missed,
+           drv_dvr_status_last_led_pattern() == want ? "done" : "FAILED, LED unchanged",
+           (unsigned long)done, st.retries, st.confirmed, st.failed);
+}
+
+int main()
+{
+    printf("REC_START from a solid LED\n");
+    for (int m = 0; m < 4; m++)
+        trial(DVR_GEST_REC_START, m);
+
+    printf("REC_STOP during a slow blink\n");
+    for (int m = 0; m < 4; m++)
+        trial(DVR_GEST_REC_STOP, m);
+    return 0;
+}
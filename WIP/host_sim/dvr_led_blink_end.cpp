@@ -0,0 +1,129 @@
+// dvr_led_blink_end.cpp
+//
+// Blink-end latency of the DVR LED classifier (user-034 figures).
+// LED solid 3 s, then 23 blink edges, then the LED stays at a random level
+// (alternating off / on per trial). Measured from the last edge to SOLID or
+// OFF, 200 trials per row, classifier polled every 1 ms. A SOLID/OFF report
+// while still blinking counts as a premature end.
+//
+//   run.sh dvr_led_blink_end
+//   run.sh dvr_led_blink_end CFG_DVR_LED_ISR_CLASSIFIER=1
+//
+// SOURCES: src/dvr_led.cpp src/hw_timer.cpp src/led_cal.cpp src/crc8.cpp
+
+#include "sim.h"
+
+#include <vector>
+#include <algorithm>
+
+#include "dvr_led.h"
+
+extern "C" void INT1_vect(void);
+
+static uint64_t s_t;
+static int      s_premature = 0;
+
+static bool is_blink(dvr_led_pattern_t p)
+{
+    return p == DVR_LED_SLOW_BLINK || p == DVR_LED_FAST_BLINK;
+}
+
+static void edge(int off)
+{
+    sim_led_level(off);
+    sim_set_time(s_t);
+    INT1_vect();
+}
+
+// ms from the last edge to SOLID/OFF, -1 on a premature end
+static double trial(double on_ms, double off_ms, double pct, int end_off)
+{
+    s_t = SIM_T0_TK;
+    sim_set_time(s_t);
+    sim_led_level(0);
+    dvr_led_init();
+
+    for (const uint64_t end = s_t + 3000 * SIM_TK_PER_MS; s_t < end; s_t += 200)
+    {
+        sim_set_time(s_t);
+        if ((s_t / 200) % 10 == 0)
+            dvr_led_poll(millis());
+    }
+
+    int  off  = 1;
+    bool seen = false;
+    for (int i = 0; i < 24; i++)
+    {
+        edge(off);
+        const double dur = sim_jitter(off ? off_ms : on_ms, pct);
+
+        if (i == 23)
+        {
+            // Last edge: finish on the requested level
+            if (off != end_off)
+            {
+                off ^= 1;
+                s_t += (uint64_t)(dur * SIM_TK_PER_MS);
+                edge(off);
+            }
+            break;
+        }
+
+        for (const uint64_t end = s_t + (uint64_t)(dur * SIM_TK_PER_MS); s_t < end; s_t += 200)
+        {
+            sim_set_time(s_t);
+            if ((s_t / 200) % 10 != 0)
+                continue;
+            dvr_led_poll(millis());
+            const dvr_led_pattern_t p = dvr_led_get_pattern();
+            if (is_blink(p))
+                seen = true;
+            else if (seen)
+            {
+                s_premature++;
+                return -1;
+            }
+        }
+        off ^= 1;
+    }
+
+    const uint64_t t_last = s_t;
+    for (;; s_t += 200)
+    {
+        sim_set_time(s_t);
+        if ((s_t / 200) % 10 != 0)
+            continue;
+        dvr_led_poll(millis());
+        const dvr_led_pattern_t p = dvr_led_get_pattern();
+        if (p == DVR_LED_SOLID || p == DVR_LED_OFF)
+            return (double)(s_t - t_last) / SIM_TK_PER_MS;
+    }
+}
+
+static void row(const char* name, double on_ms, double off_ms, double pct)
+{
+    std::vector<double> v;
+    s_premature = 0;
+
+    srand(1);
+    for (int i = 0; i < 200; i++)
+    {
+        const double x = trial(on_ms, off_ms, pct, i & 1);
+        if (x >= 0)
+            v.push_back(x);
+    }
+    std::sort(v.begin(), v.end());
+
+    printf("%-24s p50 %5.0f  p90 %5.0f  max %5.0f ms  premature %d\n",
+           name, v[v.size() / 2], v[v.size() * 9 / 10], v.back(), s_premature);
+}
+
+int main()
+{
+    row("slow 1000/1000 +-5%",  1000, 1000, 0.05);
+    row("slow 1000/1000 +-15%", 1000, 1000, 0.15);
+    row("slow  700/1300 +-5%",   700, 1300, 0.05);
+    row("fast  100/100  +-5%",   100,  100, 0.05);
+    row("fast  100/100  +-15%",  100,  100, 0.15);
+    return 0;
+}
@@ -0,0 +1,135 @@
+// dvr_led_glitch.cpp
+//
+// Slow-blink confidence under disturbances (user-036 figures).
+// LED solid 3 s, then 40 slow cycles (1000/1000 ms). From cycle 3 on, every
+// Nth OFF half carries a disturbance:
+//   glitch  : 20 ms ON spike in the middle of the OFF half
+//   chatter : 3 x 100/100 ms fast flashes in place of the OFF half
+// Reported after the first SLOW commit: time the confidence spent below the
+// two-hit level, pattern changes, and how many of them were FAST.
+//
+//   run.sh dvr_led_glitch
+//
+// Before user-036 the confidence was the raw hit count, so the two-hit
+// level is 2 there:
+//   ROOT=<checkout of 7ced1d5^> run.sh dvr_led_glitch -DSIM_CONF_OK=2
+//
+// SOURCES: src/dvr_led.cpp src/hw_timer.cpp src/led_cal.cpp src/crc8.cpp
+
+#include "sim.h"
+
+#include "dvr_led.h"
+
+extern "C" void INT1_vect(void);
+
+#ifndef SIM_CONF_OK
+  #define SIM_CONF_OK 120   // two hits (commit level)
+#endif
+
+enum disturb_t { DIST_NONE, DIST_GLITCH, DIST_CHATTER };
+
+struct glitch_result_t
+{
+    double low_ms;
+    int    changes;
+    int    fast;
+};
+
+static uint64_t        s_t;
+static glitch_result_t s_r;
+static int             s_cur;
+static bool            s_acquired;
+
+// Hold the LED at `off` for ms, polling every 1 ms
+static void seg(int off, double ms)
+{
+    if (sim_led_is_off() != off)
+    {
+        sim_led_level(off);
+        sim_set_time(s_t);
+        INT1_vect();
+    }
+
+    for (const uint64_t end = s_t + (uint64_t)(ms * SIM_TK_PER_MS); s_t < end; s_t += SIM_TK_PER_MS)
+    {
+        sim_set_time(s_t);
+        dvr_led_poll(millis());
+
+        const int p = dvr_led_get_pattern();
+        if (p == DVR_LED_SLOW_BLINK)
+            s_acquired = true;
+        if (s_acquired)
+        {
+            if (dvr_led_get_confidence() < SIM_CONF_OK)
+                s_r.low_ms += 1;
+            if (p != s_cur)
+            {
+                s_r.changes++;
+                if (p == DVR_LED_FAST_BLINK)
+                    s_r.fast++;
+            }
+        }
+        s_cur = p;
+    }
+}
+
+static glitch_result_t run(int cycles, int every, disturb_t kind, double pct)
+{
+    s_t = SIM_T0_TK;
+    sim_set_time(s_t);
+    sim_led_level(0);
+    dvr_led_init();
+
+    s_r        = glitch_result_t{ 0, 0, 0 };
+    s_cur      = -1;
+    s_acquired = false;
+
+    seg(0, 3000);
+    for (int c = 0; c < cycles; c++)
+    {
+        if (kind != DIST_NONE && c > 2 && c % every == 0)
+        {
+            if (kind == DIST_GLITCH)
+            {
+                seg(1, 500);
+                seg(0, 20);
+                seg(1, 480);
+            }
+            else
+            {
+                seg(1, 400);
+                for (int k = 0; k < 3; k++)
+                {
+                    seg(0, 100);
+                    seg(1, 100);
+                }
+            }
+        }
+        else
+        {
+            seg(1, sim_jitter(1000, pct));
+        }
+        seg(0, sim_jitter(1000, pct));
+    }
+    return s_r;
+}
+
+int main()
+{
+    struct { const char* name; int every; disturb_t kind; double pct; } rows[] =
+    {
+        { "clean +-5%",            0, DIST_NONE,    0.05 },
+        { "glitch every 5",        5, DIST_GLITCH,  0.05 },
+        { "chatter every 7",       7, DIST_CHATTER, 0.05 },
+        { "glitch every 3 +-15%",  3, DIST_GLITCH,  0.15 },
+    };
+
+    srand(1);
+    for (const auto& row : rows)
+    {
+        const glitch_result_t r = run(40, row.every, row.kind, row.pct);
+        printf("%-22s conf < %3d for %6.0f ms  changes %2d  fast %d\n",
+               row.name, SIM_CONF_OK, r.low_ms, r.changes, r.fast);
+    }
+    return 0;
+}
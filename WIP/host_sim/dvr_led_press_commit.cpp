@@ -0,0 +1,105 @@
+// dvr_led_press_commit.cpp
+//
+// Record-start latency of the DVR LED classifier (user-033 figures).
+// LED solid for 3 s, record press at 3 s, the DVR starts blinking 300-800 ms
+// later. Measured from the press to DVR_LED_SLOW_BLINK, 200 trials per row,
+// classifier polled every 1 ms. "No press" leaves the press prior out.
+//
+//   run.sh dvr_led_press_commit                              fast commit
+//   run.sh dvr_led_press_commit CFG_DVR_LED_FAST_COMMIT=0    conservative
+//
+// SOURCES: src/dvr_led.cpp src/hw_timer.cpp src/led_cal.cpp src/crc8.cpp
+
+#include "sim.h"
+
+#include <vector>
+#include <algorithm>
+
+#include "config.h"
+#include "dvr_led.h"
+
+extern "C" void INT1_vect(void);
+
+static uint64_t s_t;
+
+static void advance_ms(double ms)
+{
+    const uint64_t end = s_t + (uint64_t)(ms * SIM_TK_PER_MS);
+    for (; s_t < end; s_t += 200)
+    {
+        sim_set_time(s_t);
+        if ((s_t / 200) % 10 == 0)
+            dvr_led_poll(millis());
+    }
+}
+
+// ms from press to SLOW_BLINK, -1 if it never committed
+static double trial(double on_ms, double off_ms, double pct, bool press)
+{
+    s_t = SIM_T0_TK;
+    sim_set_time(s_t);
+    sim_led_level(0);
+    dvr_led_init();
+
+    advance_ms(3000);
+
+    const uint64_t t_press = s_t;
+    if (press)
+        dvr_led_note_toggle_press();
+
+    advance_ms(300 + rand() % 500);
+
+    int off = 1;   // first edge: LED goes off
+    for (int i = 0; i < 20; i++)
+    {
+        sim_led_level(off);
+        sim_set_time(s_t);
+        INT1_vect();
+
+        const uint64_t end = s_t + (uint64_t)(sim_jitter(off ? off_ms : on_ms, pct) * SIM_TK_PER_MS);
+        for (; s_t < end; s_t += 200)
+        {
+            sim_set_time(s_t);
+            if ((s_t / 200) % 10 != 0)
+                continue;
+            dvr_led_poll(millis());
+            if (dvr_led_get_pattern() == DVR_LED_SLOW_BLINK)
+                return (double)(s_t - t_press) / SIM_TK_PER_MS;
+        }
+        off ^= 1;
+    }
+    return -1;
+}
+
+static void row(const char* name, double on_ms, double off_ms, double pct, bool press)
+{
+    std::vector<double> v;
+    int missed = 0;
+
+    srand(1);
+    for (int i = 0; i < 200; i++)
+    {
+        const double x = trial(on_ms, off_ms, pct, press);
+        if (x < 0) missed++;
+        else       v.push_back(x);
+    }
+    std::sort(v.begin(), v.end());
+
+    if (v.empty())
+    {
+        printf("%-36s never committed\n", name);
+        return;
+    }
+    printf("%-36s p50 %5.0f  p90 %5.0f  max %5.0f ms  (missed %d)\n",
+           name, v[v.size() / 2], v[v.size() * 9 / 10], v.back(), missed);
+}
+
+int main()
+{
+    printf("CFG_DVR_LED_FAST_COMMIT=%d\n", (int)CFG_DVR_LED_FAST_COMMIT);
+    row("1000/1000 ms +-5%",        1000, 1000, 0.05, true);
+    row("1000/1000 ms +-15%",       1000, 1000, 0.15, true);
+    row("700/1300 ms (ambiguous)",   700, 1300, 0.05, true);
+    row("1000/1000 ms +-5%, no press", 1000, 1000, 0.05, false);
+    return 0;
+}
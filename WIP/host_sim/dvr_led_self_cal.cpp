@@ -0,0 +1,142 @@
+// dvr_led_self_cal.cpp
+//
+// Blink-timing self-calibration (user-038 figures).
+// For three simulated DVR units: record-start latency with the defaults,
+// then one 30-period recording for the classifier to learn from, then the
+// same latency again. Latency is from the record press to SLOW_BLINK, DVR
+// reacting 300-800 ms after the press, 100 trials, +-5 % jitter, classifier
+// polled every 1 ms. Also prints the learned SLOW timing, the EEPROM bytes
+// written and whether dvr_led_init() reloads it.
+//
+//   run.sh dvr_led_self_cal
+//
+// SOURCES: src/dvr_led.cpp src/hw_timer.cpp src/led_cal.cpp src/crc8.cpp
+
+#include "sim.h"
+
+#include <vector>
+#include <algorithm>
+
+#include "dvr_led.h"
+
+extern "C" void INT1_vect(void);
+extern int g_ee_writes;
+
+static const uint8_t SLOT_SLOW = 1;   // signature row learned by dvr_led
+
+static uint64_t s_t = SIM_T0_TK;
+
+static void edge(int off)
+{
+    sim_led_level(off);
+    sim_set_time(s_t);
+    INT1_vect();
+}
+
+static void hold_ms(double ms)
+{
+    for (const uint64_t end = s_t + (uint64_t)(ms * SIM_TK_PER_MS); s_t < end; s_t += SIM_TK_PER_MS)
+    {
+        sim_set_time(s_t);
+        dvr_led_poll(millis());
+    }
+}
+
+// n periods of on/off, then solid for 6 s (blink end, learning commits)
+static void blink(double on_ms, double off_ms, double pct, int n)
+{
+    int off = 1;
+    for (int i = 0; i < 2 * n; i++)
+    {
+        edge(off);
+        hold_ms(sim_jitter(off ? off_ms : on_ms, pct));
+        off ^= 1;
+    }
+    edge(0);
+    hold_ms(6000);
+}
+
+// ms from press to SLOW_BLINK, -1 if it never committed
+static double trial(double on_ms, double off_ms, double pct)
+{
+    sim_set_time(s_t);
+    sim_led_level(0);
+    dvr_led_init();
+    hold_ms(3000);
+
+    const uint64_t t_press = s_t;
+    dvr_led_note_toggle_press();
+    hold_ms(300 + rand() % 500);
+
+    double res = -1;
+    int    off = 1;
+    for (int i = 0; i < 12; i++)
+    {
+        edge(off);
+        const uint64_t end = s_t + (uint64_t)(sim_jitter(off ? off_ms : on_ms, pct) * SIM_TK_PER_MS);
+        for (; s_t < end; s_t += SIM_TK_PER_MS)
+        {
+            sim_set_time(s_t);
+            dvr_led_poll(millis());
+            if (res < 0 && dvr_led_get_pattern() == DVR_LED_SLOW_BLINK)
+                res = (double)(s_t - t_press) / SIM_TK_PER_MS;
+        }
+        off ^= 1;
+    }
+    edge(0);
+    hold_ms(6000);
+    return res;
+}
+
+static void latency(const char* name, double on_ms, double off_ms, double pct)
+{
+    std::vector<double> v;
+
+    srand(2);
+    for (int i = 0; i < 100; i++)
+    {
+        const double x = trial(on_ms, off_ms, pct);
+        if (x >= 0)
+            v.push_back(x);
+    }
+    std::sort(v.begin(), v.end());
+
+    printf("  %-11s p50 %5.0f  p90 %5.0f  max %5.0f ms  (n=%zu)\n",
+           name, v[v.size() / 2], v[v.size() * 9 / 10], v.back(), v.size());
+}
+
+int main()
+{
+    struct { const char* name; double on_ms; double off_ms; } units[] =
+    {
+        { "1000/1000 +-5%",             1000, 1000 },
+        { "700/1300 +-5% (skewed)",      700, 1300 },
+        { "1150/1150 +-5% (slow unit)", 1150, 1150 },
+    };
+
+    for (const auto& u : units)
+    {
+        dvr_led_cal_clear();
+        printf("%s\n", u.name);
+        latency("defaults", u.on_ms, u.off_ms, 0.05);
+
+        // One long recording to learn from
+        sim_set_time(s_t);
+        sim_led_level(0);
+        dvr_led_init();
+        hold_ms(3000);
+
+        const int w0 = g_ee_writes;
+        blink(u.on_ms, u.off_ms, 0.05, 30);
+
+        uint16_t on = 0, off = 0, on2 = 0, off2 = 0;
+        const bool learned = dvr_led_cal_get(SLOT_SLOW, &on, &off);
+        dvr_led_init();
+        const bool reloaded = dvr_led_cal_get(SLOT_SLOW, &on2, &off2);
+        printf("  learned %d on %u off %u, EEPROM bytes %d; reload %d on %u off %u\n",
+               learned, on, off, g_ee_writes - w0, reloaded, on2, off2);
+
+        latency("calibrated", u.on_ms, u.off_ms, 0.05);
+    }
+    return 0;
+}
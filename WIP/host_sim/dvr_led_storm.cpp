@@ -0,0 +1,129 @@
+// dvr_led_storm.cpp
+//
+// INT1 edge-storm guard (user-037 event counts).
+// Slow blink (1000/1000 ms) with a 4 s square-wave storm from 10 s to 14 s.
+// The line is stepped every 5 us; INT1 only runs while EIMSK enables it and
+// the Timer2 sampler only while TIMSK2 enables it, as on the chip. INT1 and
+// sampler counts cover the storm window; trips cover the whole run. The
+// pattern timeline is printed with -DSIM_VERBOSE.
+//
+//   run.sh dvr_led_storm
+//   run.sh dvr_led_storm CFG_DVR_LED_STORM_GUARD=0     unguarded: every edge
+//
+// SOURCES: src/dvr_led.cpp src/hw_timer.cpp src/led_cal.cpp src/crc8.cpp
+
+#include "sim.h"
+
+#include "config.h"
+#include "dvr_led.h"
+
+extern "C" void INT1_vect(void);
+#if CFG_DVR_LED_STORM_GUARD
+extern "C" void TIMER2_COMPA_vect(void);
+#endif
+
+static const uint64_t STORM_FROM = SIM_T0_TK + 10000 * SIM_TK_PER_MS;
+static const uint64_t STORM_TO   = SIM_T0_TK + 14000 * SIM_TK_PER_MS;
+
+static uint64_t s_t;
+static int      s_off;
+static long     s_int1;
+static long     s_t2;
+static uint32_t s_half_tk;   // storm half period
+
+static int level_at(uint64_t tk)
+{
+    if (tk >= STORM_FROM && tk < STORM_TO)
+        return (int)((tk / s_half_tk) & 1u);
+    return (int)((tk / (1000 * SIM_TK_PER_MS)) & 1u);   // slow blink
+}
+
+static void step_to(uint64_t end)
+{
+    for (; s_t < end; s_t += 10)
+    {
+        sim_set_time(s_t);
+
+        const int off = level_at(s_t);
+        if (off != s_off)
+        {
+            s_off = off;
+            sim_led_level(off);
+            if (EIMSK & _BV(INT1))
+            {
+                s_int1++;
+                INT1_vect();
+            }
+        }
+#if CFG_DVR_LED_STORM_GUARD
+        if ((TIMSK2 & _BV(OCIE2A)) && (s_t % SIM_TK_PER_MS) == 0)
+        {
+            s_t2++;
+            TIMER2_COMPA_vect();
+        }
+#endif
+        if ((s_t % (10 * SIM_TK_PER_MS)) == 0)
+            dvr_led_poll(millis());
+    }
+}
+
+static void run(const char* name, uint32_t half_tk)
+{
+    s_t       = SIM_T0_TK;
+    s_off     = 1;
+    s_int1    = 0;
+    s_t2      = 0;
+    s_half_tk = half_tk;
+    sim_set_time(s_t);
+    sim_led_level(1);
+    dvr_led_init();
+
+    long int1_storm = 0;
+    long t2_storm   = 0;
+    int  cur        = -1;
+    bool active     = false;
+
+    for (uint64_t ms = 500; ms <= 24000; ms += 100)
+    {
+        const long     i0 = s_int1;
+        const long     t0 = s_t2;
+        const uint64_t at = SIM_T0_TK + ms * SIM_TK_PER_MS;
+
+        step_to(at);
+
+        if (at > STORM_FROM && at <= STORM_TO)
+        {
+            int1_storm += s_int1 - i0;
+            t2_storm   += s_t2 - t0;
+        }
+
+#ifdef SIM_VERBOSE
+        const int p = dvr_led_get_pattern();
+        if (p != cur || dvr_led_storm_active() != active)
+        {
+            printf("  t=%5llu ms %-5s conf=%3u storm=%d trips=%u\n",
+                   (unsigned long long)ms, sim_pattern_name(p), dvr_led_get_confidence(),
+                   dvr_led_storm_active(), dvr_led_storm_trips());
+            cur    = p;
+            active = dvr_led_storm_active();
+        }
+#else
+        (void)cur;
+        (void)active;
+#endif
+    }
+
+    printf("%-26s storm 4 s: INT1 entries %6ld (edges %6ld)  sampler ticks %5ld  trips %u  after: %s%s\n",
+           name, int1_storm, (long)(4000.0 * SIM_TK_PER_MS / half_tk), t2_storm,
+           (unsigned)dvr_led_storm_trips(),
+           sim_pattern_name(dvr_led_get_pattern()),
+           dvr_led_storm_active() ? " (still sampled)" : "");
+}
+
+int main()
+{
+    printf("CFG_DVR_LED_STORM_GUARD=%d\n", (int)CFG_DVR_LED_STORM_GUARD);
+    run("20 kHz (25 us half)",   50);
+    run("~7.3 kHz (68.5 us half)", 137);
+    return 0;
+}
@@ -0,0 +1,77 @@
+// hw_adc_noise.cpp
+//
+// Threshold decisions on single vs. oversampled readings (user-044 figures,
+// 14e4c87). hw_adc's ADC_vect is fed 10-bit conversions of a level sitting
+// 0.5 or 1.0 LSB above a threshold T, with 1 LSB rms Gaussian input noise
+// (rounded to the nearest code). Bandgap slots, where the tree has them, get
+// the nominal bandgap code. Prints the share of readings on the wrong side
+// of T: single conversions (raw < T) and published 12-bit results
+// (result < ADC_OS(T)).
+//
+//   run.sh hw_adc_noise
+//
+// SOURCES: src/hw_adc.cpp
+
+#include "sim.h"
+
+#include <math.h>
+
+#include "hw_adc.h"
+#include "thresholds.h"
+
+extern "C" void ADC_vect(void);
+
+static const uint16_t T       = ADC_LOCKOUT_ENTER;   // any mid-scale code
+static const int      RESULTS = 20000;
+
+static double gauss(void)
+{
+    const double u1 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    const double u2 = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+static void run(double above_lsb)
+{
+    hw_adc_init();
+
+    long singles = 0, single_wrong = 0;
+    long results = 0, result_wrong = 0;
+
+    while (results < RESULTS)
+    {
+        if ((ADMUX & 0x0F) == 0x0E)
+        {
+            ADC = 225;   // bandgap slot: 1.1 V at AVCC 5.00 V
+        }
+        else
+        {
+            const long code = lround(T + above_lsb + gauss());
+            ADC = (uint16_t)(code < 0 ? 0 : code > 1023 ? 1023 : code);
+            singles++;
+            if (ADC < T)
+                single_wrong++;
+        }
+        ADC_vect();
+
+        uint16_t r;
+        if (hw_adc_take(&r))
+        {
+            results++;
+            if (r < ADC_OS(T))
+                result_wrong++;
+        }
+    }
+
+    printf("  T + %.1f LSB:  single conversion %5.1f %%   12-bit result %5.1f %%\n", above_lsb,
+           100.0 * single_wrong / singles, 100.0 * result_wrong / results);
+}
+
+int main()
+{
+    printf("wrong side of T, 1 LSB rms noise, %d results each:\n", RESULTS);
+    srand(1);
+    run(0.5);
+    run(1.0);
+    return 0;
+}
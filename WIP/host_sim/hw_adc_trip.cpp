@@ -0,0 +1,106 @@
+// hw_adc_trip.cpp
+//
+// Battery lockout threshold trip against pack traces (user-045 figures,
+// 84a62dd / 6db2480). hw_adc's ADC_vect is fed one battery conversion per
+// 1.024 ms slot (Timer0 auto-trigger) from a loaded-pack voltage trace,
+// through the 505k/135k divider with +-2 LSB noise. The trip is armed as
+// drv_fuel_gauge arms it at REC load with unity calibration (loaded lockout
+// level, less ADC_TRIP_MARGIN_MV on trees that have it). Prints how long
+// after the drop each collapse trips, and whether the transient loads trip
+// at all.
+//
+//   run.sh hw_adc_trip
+//   ROOT=<checkout of 6db2480^> run.sh hw_adc_trip
+//
+// SOURCES: src/hw_adc.cpp
+
+#include "sim.h"
+
+#include <math.h>
+
+#include "hw_adc.h"
+#include "thresholds.h"
+
+extern "C" void ADC_vect(void);
+
+typedef double (*trace_fn)(double t_ms);   // loaded pack voltage, mV
+
+static double   s_t_ms;
+static double   s_trip_at;
+static uint16_t s_level;
+
+static void on_trip(uint16_t)
+{
+    if (s_trip_at < 0)
+        s_trip_at = s_t_ms;
+}
+
+static uint16_t mv_to_raw(double mv)
+{
+    return (uint16_t)lround(mv * 135036.0 / 505000.0 / 4.0 + ((rand() % 5) - 2));
+}
+
+// ms of the first trip, -1 if none
+static double run(trace_fn f, double dur_ms)
+{
+    hw_adc_init();
+    s_trip_at = -1;
+    hw_adc_trip_arm(s_level, ADC_TRIP_CONVERSIONS, on_trip);
+
+    for (s_t_ms = 0; s_t_ms < dur_ms; s_t_ms += 1.024)
+    {
+        ADC = mv_to_raw(f(s_t_ms));
+        ADC_vect();
+    }
+    return s_trip_at;
+}
+
+// -----------------------------------------------------------------------------
+// Traces
+// -----------------------------------------------------------------------------
+static double collapse_63(double t) { return t < 1000 ? 7000 : 6300; }   // cell drops out
+static double collapse_65(double t) { return t < 1000 ? 7000 : 6500; }
+static double collapse_66(double t) { return t < 1000 ? 7000 : 6600; }   // just under the level
+
+// +300 mA x 250 mOhm for 40 ms every 250 ms; +400 mA for 150 ms every 1 s
+static double sd_writes(double t) { return 6700 - ((t >= 100 && fmod(t - 100, 250) < 40) ? 75 : 0); }
+static double sd_long(double t) { return 6700 - ((t >= 100 && fmod(t - 100, 1000) < 150) ? 100 : 0); }
+
+// PhotoMOS closing onto the DVR's input caps, every 2 s
+static double inrush(double t) { return t < 100 ? 6750 : 6750 - 1500 * exp(-fmod(t - 100, 2000) / 3.0); }
+static double inrush_long(double t) { return t < 100 ? 6750 : 6750 - 800 * exp(-fmod(t - 100, 2000) / 10.0); }
+
+int main()
+{
+    int32_t level = (int32_t)ADC_OS(ADC_LOCKOUT_ENTER) - (int32_t)ADC_OS_MV(BAT_SAG_MV(BAT_I_DVR_REC_MA));
+#ifdef ADC_TRIP_MARGIN_MV
+    level -= (int32_t)ADC_OS_MV(ADC_TRIP_MARGIN_MV);
+#endif
+    s_level = (uint16_t)((level + 2) >> 2);
+    printf("trip level raw %u (~%.0f mV loaded), %u conversions\n",
+           s_level, level * 505000.0 / 135036.0, (unsigned)ADC_TRIP_CONVERSIONS);
+
+    struct { const char* name; trace_fn f; double drop_ms; } rows[] =
+    {
+        { "collapse 7.0 -> 6.3 V",                  collapse_63, 1000 },
+        { "collapse 7.0 -> 6.6 V",                  collapse_66, 1000 },
+        { "collapse 7.0 -> 6.5 V",                  collapse_65, 1000 },
+        { "SD writes 75 mV x 40 ms @ 6.70 V",       sd_writes,   -1 },
+        { "SD writes 100 mV x 150 ms @ 6.70 V",     sd_long,     -1 },
+        { "PhotoMOS inrush 1.5 V, tau 3 ms @ 6.75 V",  inrush,      -1 },
+        { "PhotoMOS inrush 0.8 V, tau 10 ms @ 6.75 V", inrush_long, -1 },
+    };
+
+    srand(1);
+    for (const auto& row : rows)
+    {
+        const double at = run(row.f, 10000);
+        if (at < 0)
+            printf("  %-42s no trip\n", row.name);
+        else if (row.drop_ms < 0)
+            printf("  %-42s TRIPPED at %.0f ms\n", row.name, at);
+        else
+            printf("  %-42s trip %.1f ms after the drop\n", row.name, at - row.drop_ms);
+    }
+    return 0;
+}
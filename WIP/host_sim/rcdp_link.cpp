@@ -0,0 +1,199 @@
+// rcdp_link.cpp
+//
+// RunCam UART control link (user-043 figures, 5fc142f).
+// rcdp against a simulated camera through the injected rcdp_io_t. Wire model:
+// 115200 8N1, one byte every 86.8 us (174 ticks) in each direction; the
+// camera answers GET_DEVICE_INFO 1 ms after the request's last byte and
+// acts on CAMERA_CONTROL as soon as its frame is in. rcdp_poll() runs every
+// 0.5 ms. Prints, per START/STOP command, when the camera acted and the link
+// ack round trip; then a corrupt reply, and the camera switched off and on.
+// Also prints the CRC-8/DVB-S2 check value.
+//
+//   run.sh rcdp_link
+//
+// SOURCES: src/rcdp.cpp src/crc8.cpp src/hw_timer.cpp
+
+#include "sim.h"
+
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+#include "rcdp.h"
+#include "crc8.h"
+
+static const uint64_t BYTE_TK = 174;    // 10 bits at 115200
+static const uint64_t PROC_TK = 2000;   // camera processing, 1 ms
+
+struct wire_byte_t
+{
+    uint64_t at;
+    uint8_t  b;
+};
+
+static std::deque<wire_byte_t> s_to_cam;
+static std::deque<wire_byte_t> s_to_mcu;
+static uint64_t                s_cam_tx_free;
+static uint64_t                s_mcu_tx_free;
+static std::vector<uint8_t>    s_cam_buf;
+static bool                    s_cam_alive = true;
+static int                     s_cam_rec   = 0;
+static int                     s_corrupt   = 0;   // replies to corrupt
+static uint64_t                s_t         = SIM_T0_TK;
+
+// -----------------------------------------------------------------------------
+// MCU side of the wire
+// -----------------------------------------------------------------------------
+static int16_t io_rx(void)
+{
+    if (s_to_mcu.empty() || s_to_mcu.front().at > g_sim_tk)
+        return -1;
+    const uint8_t b = s_to_mcu.front().b;
+    s_to_mcu.pop_front();
+    return b;
+}
+
+static bool io_tx(const uint8_t* p, uint8_t n)
+{
+    for (uint8_t i = 0; i < n; i++)
+    {
+        s_mcu_tx_free = std::max(s_mcu_tx_free, g_sim_tk) + BYTE_TK;
+        s_to_cam.push_back({ s_mcu_tx_free, p[i] });
+    }
+    return true;
+}
+
+static const rcdp_io_t s_io = { io_rx, io_tx };
+
+// -----------------------------------------------------------------------------
+// Camera
+// -----------------------------------------------------------------------------
+static void cam_reply_info(void)
+{
+    uint8_t r[5] = { 0xCC, 0x01, 0xC0, 0x00, 0 };   // v1, START/STOP_RECORDING
+    r[4] = crc8_dvb_s2(r, 4);
+    if (s_corrupt)
+    {
+        r[4] ^= 1;
+        s_corrupt--;
+    }
+
+    const uint64_t t = g_sim_tk + PROC_TK;
+    for (int i = 0; i < 5; i++)
+    {
+        s_cam_tx_free = std::max(s_cam_tx_free, t) + BYTE_TK;
+        s_to_mcu.push_back({ s_cam_tx_free, r[i] });
+    }
+}
+
+static void cam_step(void)
+{
+    while (!s_to_cam.empty() && s_to_cam.front().at <= g_sim_tk)
+    {
+        const uint8_t b = s_to_cam.front().b;
+        s_to_cam.pop_front();
+        if (!s_cam_alive)
+            continue;
+        if (s_cam_buf.empty() && b != 0xCC)
+            continue;
+        s_cam_buf.push_back(b);
+
+        const uint8_t* f = s_cam_buf.data();
+        if (s_cam_buf.size() == 3 && f[1] == 0x00)
+        {
+            if (crc8_dvb_s2(f, 2) == f[2])
+                cam_reply_info();
+            s_cam_buf.clear();
+        }
+        else if (s_cam_buf.size() == 4 && f[1] == 0x01)
+        {
+            if (crc8_dvb_s2(f, 3) == f[3])
+            {
+                if (f[2] == RCDP_CTRL_START_RECORDING)
+                    s_cam_rec = 1;
+                if (f[2] == RCDP_CTRL_STOP_RECORDING)
+                    s_cam_rec = 0;
+            }
+            s_cam_buf.clear();
+        }
+        else if (s_cam_buf.size() > 4)
+        {
+            s_cam_buf.clear();
+        }
+    }
+}
+
+// -----------------------------------------------------------------------------
+static void step(void)
+{
+    sim_set_time(s_t);
+    cam_step();
+    if ((s_t % 1000) == 0)
+        rcdp_poll(millis());
+    s_t += 20;
+}
+
+static void run_ms(double ms)
+{
+    for (const uint64_t end = s_t + (uint64_t)(ms * SIM_TK_PER_MS); s_t < end;)
+        step();
+}
+
+int main()
+{
+    printf("crc8_dvb_s2(\"123456789\") = 0x%02X\n", crc8_dvb_s2((const uint8_t*)"123456789", 9));
+
+    sim_set_time(s_t);
+    rcdp_init(&s_io);
+    run_ms(50);
+    printf("link up %d  features 0x%04X\n", rcdp_link_up(), rcdp_features());
+
+    for (int k = 0; k < 4; k++)
+    {
+        const int      want = (k % 2 == 0);
+        const uint64_t t0   = s_t;
+        const bool     ok   = rcdp_request(want ? RCDP_CTRL_START_RECORDING : RCDP_CTRL_STOP_RECORDING);
+
+        rcdp_stats_t s0;
+        rcdp_get_stats(&s0);
+        uint64_t t_act = 0;
+        while (s_t < t0 + 100 * SIM_TK_PER_MS)
+        {
+            step();
+            if (!t_act && s_cam_rec == want)
+                t_act = s_t;
+
+            rcdp_stats_t s;
+            rcdp_get_stats(&s);
+            if (s.acks > s0.acks)
+                break;
+        }
+
+        rcdp_stats_t s;
+        rcdp_get_stats(&s);
+        printf("%-5s accepted %d  camera acted after %.2f ms  link ack rtt %.2f ms\n",
+               want ? "START" : "STOP", ok, (double)(t_act - t0) / SIM_TK_PER_MS,
+               (double)s.last_rtt_tk / SIM_TK_PER_MS);
+        run_ms(1500);
+    }
+
+    rcdp_stats_t s;
+    s_corrupt = 1;
+    run_ms(1100);
+    rcdp_get_stats(&s);
+    printf("corrupt reply:  crc errors %u  link up %d\n", s.crc_errors, rcdp_link_up());
+    run_ms(1100);
+    printf("next probe:     link up %d\n", rcdp_link_up());
+
+    s_cam_alive = false;
+    run_ms(1100);
+    printf("camera off:     link up %d  request accepted %d (press path)\n",
+           rcdp_link_up(), rcdp_request(RCDP_CTRL_START_RECORDING));
+
+    s_cam_alive = true;
+    run_ms(1100);
+    rcdp_get_stats(&s);
+    printf("camera back:    link up %d  probes %u  commands %u  acks %u  timeouts %u\n",
+           rcdp_link_up(), s.probes, s.commands, s.acks, s.timeouts);
+    return 0;
+}
@@ -0,0 +1,54 @@
+#!/bin/sh
+# Build and run one host simulation (see sim.h).
+#
+#   WIP/host_sim/run.sh <name> [CFG_X=value ...] [-Dmacro ...]
+#
+#   CFG_X=value   override a config.h flag for this run (config.h is copied)
+#   -D...         passed to the compiler (simulation-specific knobs)
+#   ROOT=<tree>   take src/ and include/ from another checkout
+#
+# Needs a host g++ (C++17) and GNU sed.
+
+set -e
+
+here=$(cd "$(dirname "$0")" && pwd)
+root=${ROOT:-$(cd "$here/../.." && pwd)}
+
+[ $# -ge 1 ] || { echo "usage: $0 <name> [CFG_X=value ...] [-Dmacro ...]" >&2; exit 2; }
+name=$1
+shift
+
+sim="$here/$name.cpp"
+[ -f "$sim" ] || { echo "$0: no simulation $sim" >&2; exit 2; }
+
+out=$(mktemp -d "${TMPDIR:-/tmp}/host_sim.XXXXXX")
+trap 'rm -rf "$out"' EXIT
+
+cp -r "$root/include" "$out/include"
+
+flags=
+for a in "$@"; do
+    case $a in
+        CFG_*=*)
+            k=${a%%=*}
+            v=${a#*=}
+            grep -q "^#define $k " "$out/include/config.h" || { echo "$0: $k not in config.h" >&2; exit 2; }
+            sed -i "s/^#define $k\( *\)[0-9A-Za-z_]*/#define $k\1$v/" "$out/include/config.h"
+            ;;
+        *)
+            flags="$flags $a"
+            ;;
+    esac
+done
+
+# Sources an older tree does not have yet are skipped (ROOT=...)
+srcs=
+for s in $(sed -n 's|^// SOURCES:||p' "$sim"); do
+    [ -f "$root/$s" ] && srcs="$srcs $root/$s"
+done
+
+g++ -std=gnu++17 -O1 -w -D__AVR__ -DF_CPU=16000000UL \
+    -I"$here/stub" -I"$out/include" -I"$here" $flags \
+    "$here/stub/arduino_stub.cpp" "$sim" $srcs -o "$out/sim"
+
+"$out/sim"
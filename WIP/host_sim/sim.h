@@ -0,0 +1,79 @@
+// sim.h
+//
+// Host simulations: run the firmware's own src/*.cpp on a PC against
+// scripted input traces, to reproduce the latency / accuracy figures quoted
+// in commit messages. Not a unit-test suite and not part of the firmware
+// build; the numbers are model results, not bench measurements.
+//
+// Layout:
+//   stub/          Arduino core + avr-libc stand-ins (registers are variables)
+//   sim.h          shared helpers (this file)
+//   <name>.cpp     one simulation; its "// SOURCES:" line lists the firmware
+//                  files it links
+//   run.sh         builds and runs one simulation
+//
+// Usage (from anywhere):
+//   WIP/host_sim/run.sh dvr_led_press_commit
+//   WIP/host_sim/run.sh dvr_led_press_commit CFG_DVR_LED_FAST_COMMIT=0
+//
+// "Before" columns: build the same simulation against the parent of the
+// commit that quoted them (ROOT = a checkout of that tree):
+//   git worktree add /tmp/before <commit>^
+//   ROOT=/tmp/before WIP/host_sim/run.sh <name>
+//
+// Time model: g_sim_tk counts Timer1 ticks (2 MHz). sim_set_time() moves
+// TCNT1, the overflow extension and millis() together. The DVR LED line is
+// PD3, active low: PIND bit 3 HIGH = LED off.
+
+#pragma once
+
+#include <Arduino.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hw_timer.h"
+#include "enums.h"
+
+extern uint64_t g_sim_tk;
+
+static const uint64_t SIM_TK_PER_MS = 2000u;
+static const uint64_t SIM_T0_TK     = 1000000u;   // start 0.5 s in: nothing sits at t = 0
+
+static inline void sim_set_time(uint64_t tk)
+{
+    g_sim_tk       = tk;
+    TCNT1          = (uint16_t)tk;
+    g_hw_timer_ovf = (uint16_t)(tk >> 16);
+    TIFR1          = 0;
+}
+
+// ms since SIM_T0_TK
+static inline double sim_ms(uint64_t tk)
+{
+    return (double)(tk - SIM_T0_TK) / (double)SIM_TK_PER_MS;
+}
+
+// v +- pct (uniform), from rand(): seed with srand() for repeatable runs
+static inline double sim_jitter(double v, double pct)
+{
+    return v * (1.0 + pct * ((rand() / (double)RAND_MAX) * 2.0 - 1.0));
+}
+
+// DVR LED line level: 1 = LED off (PD3 HIGH), 0 = LED on
+static inline void sim_led_level(int off)
+{
+    PIND = off ? (uint8_t)(PIND | _BV(PD3)) : (uint8_t)(PIND & ~_BV(PD3));
+}
+
+static inline int sim_led_is_off(void)
+{
+    return (PIND & _BV(PD3)) ? 1 : 0;
+}
+
+static inline const char* sim_pattern_name(int p)
+{
+    static const char* const names[] = { "UNKNOWN", "OFF", "SOLID", "SLOW", "FAST", "ABN" };
+    return (p >= 0 && p < 6) ? names[p] : "?";
+}
@@ -0,0 +1,56 @@
+// Arduino.h (host stub)
+//
+// Just enough of the Arduino core for the firmware modules to build and run
+// on a PC. Time comes from g_sim_tk (arduino_stub.cpp); pin and serial calls
+// do nothing.
+
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/pgmspace.h>
+
+#define HIGH          1
+#define LOW           0
+#define INPUT         0
+#define OUTPUT        1
+#define INPUT_PULLUP  2
+#define CHANGE        1
+#define A0            14
+
+class __FlashStringHelper;
+#define F(s) (reinterpret_cast<const __FlashStringHelper*>(s))
+
+void     pinMode(uint8_t, uint8_t);
+void     digitalWrite(uint8_t, uint8_t);
+int      digitalRead(uint8_t);
+int      analogRead(uint8_t);
+uint32_t millis(void);
+uint32_t micros(void);
+void     delay(uint32_t);
+void     delayMicroseconds(unsigned);
+void     attachInterrupt(uint8_t, void (*)(void), int);
+void     detachInterrupt(uint8_t);
+
+#define digitalPinToInterrupt(p) ((p) == 2 ? 0 : 1)
+#define noInterrupts()           cli()
+#define interrupts()             sei()
+
+struct HardwareSerial
+{
+    void   begin(unsigned long);
+    int    available();
+    int    availableForWrite();
+    int    read();
+    size_t write(uint8_t);
+    size_t write(const uint8_t*, size_t);
+    void   flush();
+    template <class T> size_t print(T, int = 10);
+    template <class T> size_t println(T, int = 10);
+    size_t println();
+};
+
+extern HardwareSerial Serial;
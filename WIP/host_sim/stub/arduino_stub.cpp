@@ -0,0 +1,72 @@
+// arduino_stub.cpp (host stub)
+//
+// Simulated time and EEPROM behind the Arduino / avr-libc stubs.
+//   g_sim_tk   : Timer1 ticks (2 MHz); millis() / micros() derive from it
+//   g_eeprom   : 1 KiB, erased (0xFF) at start; g_ee_writes counts changed bytes
+
+#include <Arduino.h>
+#include <avr/eeprom.h>
+
+#include <string.h>
+
+uint64_t g_sim_tk = 0;
+
+HardwareSerial Serial;
+
+void   HardwareSerial::begin(unsigned long) {}
+int    HardwareSerial::available() { return 0; }
+int    HardwareSerial::availableForWrite() { return 64; }
+int    HardwareSerial::read() { return -1; }
+size_t HardwareSerial::write(uint8_t) { return 1; }
+size_t HardwareSerial::write(const uint8_t*, size_t n) { return n; }
+void   HardwareSerial::flush() {}
+template <class T> size_t HardwareSerial::print(T, int) { return 0; }
+template <class T> size_t HardwareSerial::println(T, int) { return 0; }
+size_t HardwareSerial::println() { return 0; }
+
+void     pinMode(uint8_t, uint8_t) {}
+void     digitalWrite(uint8_t, uint8_t) {}
+int      digitalRead(uint8_t) { return 0; }
+int      analogRead(uint8_t) { return 0; }
+uint32_t millis(void) { return (uint32_t)(g_sim_tk / 2000u); }
+uint32_t micros(void) { return (uint32_t)(g_sim_tk / 2u); }
+void     delay(uint32_t) {}
+void     delayMicroseconds(unsigned) {}
+void     attachInterrupt(uint8_t, void (*)(void), int) {}
+void     detachInterrupt(uint8_t) {}
+
+// -----------------------------------------------------------------------------
+// EEPROM
+// -----------------------------------------------------------------------------
+uint8_t g_eeprom[1024];
+int     g_ee_writes = 0;
+
+static struct EeInit
+{
+    EeInit() { memset(g_eeprom, 0xFF, sizeof(g_eeprom)); }
+} s_ee_init;
+
+void eeprom_read_block(void* dst, const void* addr, size_t n)
+{
+    memcpy(dst, g_eeprom + (uintptr_t)addr, n);
+}
+
+void eeprom_update_block(const void* src, void* addr, size_t n)
+{
+    for (size_t i = 0; i < n; i++)
+        eeprom_update_byte((uint8_t*)addr + i, ((const uint8_t*)src)[i]);
+}
+
+uint8_t eeprom_read_byte(const uint8_t* addr)
+{
+    return g_eeprom[(uintptr_t)addr];
+}
+
+void eeprom_update_byte(uint8_t* addr, uint8_t b)
+{
+    if (g_eeprom[(uintptr_t)addr] != b)
+    {
+        g_eeprom[(uintptr_t)addr] = b;
+        g_ee_writes++;
+    }
+}
@@ -0,0 +1,9 @@
+// avr/eeprom.h (host stub), backed by g_eeprom in arduino_stub.cpp
+
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+void eeprom_read_block(void*, const void*, size_t);
+void eeprom_update_block(const void*, void*, size_t);
+uint8_t eeprom_read_byte(const uint8_t*);
+void eeprom_update_byte(uint8_t*, uint8_t);
@@ -0,0 +1,13 @@
+// avr/interrupt.h (host stub)
+//
+// ISR(v) defines an extern "C" function the simulation calls directly.
+// cli()/sei() do nothing: a simulation is single-threaded.
+
+#pragma once
+#define ISR(v, ...) extern "C" void v(void)
+#define ISR_NAKED
+#define ISR_NOBLOCK
+#define ISR_ALIASOF(x)
+#define EMPTY_INTERRUPT(v) extern "C" void v(void){}
+#define reti()
+inline void cli(){} inline void sei(){}
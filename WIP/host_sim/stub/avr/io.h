@@ -0,0 +1,91 @@
+// avr/io.h (host stub)
+//
+// ATmega328P registers as plain variables, so ISR bodies and init code run on
+// a PC. A simulation sets inputs (PIND, TCNT1, ...) and calls the vectors.
+
+#pragma once
+#include <stdint.h>
+#define _BV(b) (1u << (b))
+#define REG(n) inline volatile uint8_t n;
+REG(PIND) REG(PORTD) REG(DDRD) REG(PINB) REG(PORTB) REG(DDRB) REG(PINC) REG(PORTC) REG(DDRC)
+REG(TCCR1A) REG(TCCR1B) REG(TCCR1C) REG(TIMSK1) REG(TIFR1) REG(TCCR2A) REG(TCCR2B) REG(TIMSK2) REG(TIFR2) REG(OCR2A) REG(TCNT2)
+REG(EICRA) REG(EIMSK) REG(EIFR) REG(ADMUX) REG(ADCSRA) REG(ADCSRB) REG(DIDR0) REG(ACSR) REG(SREG) REG(SPH) REG(SPL) REG(MCUSR) REG(TIMSK0) REG(TIFR0)
+REG(UCSR0A) REG(UCSR0B) REG(UCSR0C) REG(UDR0) REG(UBRR0H) REG(UBRR0L) REG(SMCR) REG(PRR) REG(GPIOR0)
+inline volatile uint16_t TCNT1, OCR1A, OCR1B, ICR1, ADC, UBRR0, SP;
+#define RAMEND 0x8FF
+#define RAMSTART 0x100
+#define PD0 0
+#define PD1 1
+#define PD2 2
+#define PD3 3
+#define PD4 4
+#define PD5 5
+#define PD6 6
+#define PD7 7
+#define PB0 0
+#define PB1 1
+#define PC0 0
+#define CS10 0
+#define CS11 1
+#define CS12 2
+#define TOIE1 0
+#define OCIE1A 1
+#define OCIE1B 2
+#define TOV1 0
+#define OCF1A 1
+#define OCF1B 2
+#define WGM21 1
+#define CS20 0
+#define CS21 1
+#define CS22 2
+#define OCIE2A 1
+#define OCF2A 1
+#define ISC00 0
+#define ISC01 1
+#define ISC10 2
+#define ISC11 3
+#define INT0 0
+#define INT1 1
+#define INTF0 0
+#define INTF1 1
+#define REFS0 6
+#define REFS1 7
+#define ADLAR 5
+#define MUX0 0
+#define MUX1 1
+#define MUX2 2
+#define MUX3 3
+#define ADEN 7
+#define ADSC 6
+#define ADATE 5
+#define ADIF 4
+#define ADIE 3
+#define ADPS0 0
+#define ADPS1 1
+#define ADPS2 2
+#define ADTS0 0
+#define ADTS1 1
+#define ADTS2 2
+#define ACME 6
+#define ADC0D 0
+#define ACD 7
+#define ACBG 6
+#define ACO 5
+#define ACI 4
+#define ACIE 3
+#define ACIS0 0
+#define ACIS1 1
+#define TXC0 6
+#define RXC0 7
+#define UDRE0 5
+#define RXEN0 4
+#define TXEN0 3
+#define RXCIE0 7
+#define UDRIE0 5
+#define U2X0 1
+#define UCSZ00 1
+#define UCSZ01 2
+#define SE 0
+#define SM0 1
+#define E2END 0x3FF
+#define PIND3 3
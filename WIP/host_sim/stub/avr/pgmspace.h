@@ -0,0 +1,11 @@
+// avr/pgmspace.h (host stub): flash is ordinary memory
+
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#define PROGMEM
+#define PGM_P const char*
+#define pgm_read_byte(p) (*(const uint8_t*)(p))
+#define pgm_read_word(p) (*(const uint16_t*)(p))
+#define pgm_read_dword(p) (*(const uint32_t*)(p))
+#define memcpy_P memcpy
@@ -0,0 +1,9 @@
+// avr/sleep.h (host stub)
+
+#pragma once
+#define SLEEP_MODE_IDLE 0
+#define set_sleep_mode(m)
+#define sleep_mode()
+#define sleep_enable()
+#define sleep_disable()
+#define sleep_cpu()
@@ -0,0 +1,7 @@
+// util/atomic.h (host stub): blocks run once, nothing to mask
+
+#pragma once
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_FORCEON 0
+#define ATOMIC_BLOCK(x) for (int _i = 1; _i; _i = 0)
+#define NONATOMIC_BLOCK(x) for (int _i = 1; _i; _i = 0)
@@ -0,0 +1,53 @@
+// bat_cal.h
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// bat_cal (per-unit battery ADC calibration record, EEPROM)
+// -----------------------------------------------------------------------------
+// Corrects divider tolerance and the bandgap's chip-to-chip spread (hw_adc.h)
+// with a straight line on the ratio-corrected 12-bit reading:
+//   calibrated = reading x gain_q14 / 16384 + offset
+// Taken on the bench against a known pack voltage (telemetry "<mV>k").
+//
+// Record at CFG_EE_BAT_CAL_ADDR:
+//   [version][gain_q14][offset][crc8]
+//   gain_q14 uint16_t (16384 = 1.0), offset int16_t in 12-bit counts
+//   crc8 = CRC-8/DVB-S2 over version + gain + offset
+//
+// A blank, stale-version, corrupt or out-of-range record loads as identity
+// (nominal 68k/33k divider, bandgap 1.10 V).
+//
+// Writes use eeprom_update_block() and block for a few ms per changed byte:
+// call from loop(), never from an ISR.
+// =============================================================================
+
+#define BAT_CAL_RECORD_LEN  6u       // bytes used at CFG_EE_BAT_CAL_ADDR
+#define BAT_CAL_GAIN_ONE    16384u   // Q14 1.0
+
+// Plausible per-unit spread: bandgap +-9 %, divider 1 % parts, plus margin
+#define BAT_CAL_GAIN_MIN    13926u   // 0.85
+#define BAT_CAL_GAIN_MAX    18842u   // 1.15
+#define BAT_CAL_OFFSET_MAX  40       // 12-bit counts (~150 mV at the pack)
+
+// Two points closer than this solve gain only (offset 0) from the newest one
+#define BAT_CAL_SPAN_MIN_MV 1000u
+
+typedef struct
+{
+    uint16_t gain_q14;
+    int16_t  offset;
+} bat_cal_t;
+
+// Fills *out from EEPROM. Returns false (and sets identity) if no valid record.
+bool bat_cal_load(bat_cal_t* out);
+
+void bat_cal_save(const bat_cal_t* cal);
+
+// Invalidate the record (next boot uses identity).
+void bat_cal_erase(void);
+
+// True if gain/offset sit inside the plausible spread above.
+bool bat_cal_plausible(const bat_cal_t* cal);
@@ -0,0 +1,31 @@
+// bat_runtime.h
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// bat_runtime (state of charge + recording time left, fixed point)
+// -----------------------------------------------------------------------------
+// Fed with the gauge's open-circuit estimate (12-bit oversampled counts, see
+// drv_fuel_gauge.h) once per sample:
+//
+//   est --EMA 1/8--> filtered --PROGMEM 2S LiPo curve--> SoC (permille)
+//   minutes = (SoC - SoC@lockout) x BAT_CAPACITY_MAH x 60 / BAT_I_DVR_REC_MA
+//
+// The curve is stored in ADC counts (ADC_OS_MV of the pack voltage), so the
+// lookup is compare + one interpolation, no unit conversion. SoC@lockout is
+// the curve at ADC_LOCKOUT_ENTER: minutes count down to the lockout cut, not
+// to an empty cell. No floating point anywhere.
+// =============================================================================
+
+void bat_runtime_init(void);
+
+// One open-circuit estimate per gauge sample
+void bat_runtime_update(uint16_t est_adc);
+
+// False until the first update
+bool     bat_runtime_valid(void);
+
+uint16_t bat_runtime_soc_permille(void);   // 0..1000
+uint16_t bat_runtime_rec_minutes(void);    // recording time to lockout
@@ -15,6 +15,14 @@
 // Costs RAM; disable for production if needed
 #define CFG_ENABLE_TRACE          1
 
+// Per-stage loop() profiler (Timer1 timestamps, min/avg/max + histogram)
+// Reported on demand over telemetry ('p'). 0 = compiled out entirely.
+#define CFG_LOOP_PROFILER         0
+
+// Interrupt latency probe (Timer1 COMPB) + INT1 handler duration counters
+// Reported on demand over telemetry ('i'). 0 = compiled out entirely.
+#define CFG_ISR_STATS             0
+
 // Maximum sizes (tune explicitly, never implicitly)
 #define CFG_EVENT_QUEUE_SIZE      16
 #define CFG_ACTION_QUEUE_SIZE     8
@@ -29,11 +37,59 @@
 // 1 = Timer1 1 kHz ISR (future option)
 #define CFG_TIMEBASE_MILLIS       0
 
+// Timer1 is owned by hw_timer as a free-running 2 MHz timestamp counter
+// (profiling / edge timing). It is NOT a scheduling timebase.
+
 // Polling cadences (ms)
 #define CFG_BATTERY_SAMPLE_MS     250
 #define CFG_LED_CLASSIFIER_MS     10
 #define CFG_EXECUTOR_TICK_MS      1
 
+// =============================================================================
+// DVR LED sensing / DVR control
+// =============================================================================
+
+// DVR LED classifier placement:
+// 0 = INT1 fills an edge ring, dvr_led_poll() drains + classifies
+// 1 = INT1 runs the constant-time classifier itself (no ring, no drain)
+#define CFG_DVR_LED_ISR_CLASSIFIER 0
+
+// Commit SLOW_BLINK after one tight ON+OFF pair following our own record
+// press (T_SLOW_FAST_*). 0 = always require two matching periods.
+#define CFG_DVR_LED_FAST_COMMIT   1
+
+// Minimum dvr_led_get_confidence() (0..255) before drv_dvr_led reports a
+// pattern change. Blink rows commit at 120 (two hits); quiet-time SOLID/OFF
+// always report 255.
+#define CFG_DVR_LED_EMIT_MIN_CONF 120
+
+// Edge-storm guard: mask INT1 on a chattering DVR LED line and sample it at
+// 1 kHz on Timer2 (majority filter) until clean. Timer2 must be otherwise free
+// (no tone(), no PWM on D3/D11).
+#define CFG_DVR_LED_STORM_GUARD   1
+
+// Learn the attached DVR's SLOW/FAST ON/OFF halves during confirmed blinks,
+// tighten the classifier windows around them and persist to EEPROM
+// (led_cal). 0 = compiled timings.h windows only.
+#define CFG_DVR_LED_SELF_CAL      1
+
+// Automatic re-presses per DVR gesture when the LED shows no reaction by the
+// gesture's T_CONFIRM_* deadline (dvr_confirm). 0 = track/count only.
+#define CFG_DVR_CONFIRM_RETRIES   2
+
+// RunCam Split UART control (rcdp, RunCam Device Protocol) on the hardware
+// UART (D0/D1). Record start/stop go over UART while the camera answers;
+// power gestures and any link failure fall back to contact closure.
+// Shares the UART with debug serial: requires CFG_DEBUG_SERIAL 0.
+#define CFG_DVR_UART              0
+#define CFG_DVR_UART_BAUD         115200
+
+// =============================================================================
+// EEPROM layout (byte addresses; each record carries its own version + CRC)
+// =============================================================================
+#define CFG_EE_LED_CAL_ADDR       0x000   // led_cal record (LED_CAL_RECORD_LEN bytes)
+#define CFG_EE_BAT_CAL_ADDR       0x010   // bat_cal record (BAT_CAL_RECORD_LEN bytes)
+
 // =============================================================================
 // Safety / behaviour policy
 // =============================================================================
@@ -73,3 +129,8 @@
 #if CFG_ACTION_QUEUE_SIZE > 16
   #error "Action queue too large for ATmega328P"
 #endif
+
+// One hardware UART: it is either the debug console or the RunCam link
+#if CFG_DVR_UART && CFG_DEBUG_SERIAL
+  #error "CFG_DVR_UART needs the hardware UART: set CFG_DEBUG_SERIAL 0"
+#endif
@@ -13,10 +13,11 @@
 // - consumes events from event_queue (main loop context)
 // - issues actions into action_queue (main loop context)
 // - drives presentation via ui_policy on state transitions
+// - pushes each new state to drv_fuel_gauge (load class fallback)
 //
 // Current scope:
 // - Button gestures: EV_BTN_SHORT_PRESS / EV_BTN_LONG_PRESS
-// - Battery: EV_BAT_STATE_CHANGED, EV_BAT_LOCKOUT_ENTER/EXIT
+// - Battery: EV_BAT_STATE_CHANGED, EV_BAT_LOCKOUT_ENTER/EXIT, EV_BAT_RUNTIME_LOW (cue)
 // - Booting behaviour: discards taps while STATE_BOOTING (no buffering)
 // - BOOTING -> IDLE is timeout-based for now (until DVR LED policy is integrated)
 //
@@ -0,0 +1,25 @@
+// crc8.h
+#pragma once
+
+#include <stdint.h>
+
+// =============================================================================
+// crc8 (CRC-8/DVB-S2)
+// -----------------------------------------------------------------------------
+// Polynomial 0xD5, init 0x00, no reflection, no final XOR.
+// check("123456789") = 0xBC.
+//
+// Used to validate small EEPROM records (calibration blobs) and every frame
+// on the RunCam UART link (rcdp). Table-driven: 256 bytes of flash, one
+// lookup per byte.
+//
+// Usage:
+//   uint8_t c = crc8_dvb_s2(buf, len);
+//   // or incrementally:
+//   uint8_t c = 0;
+//   c = crc8_dvb_s2_update(c, b0);
+//   c = crc8_dvb_s2_update(c, b1);
+// =============================================================================
+
+uint8_t crc8_dvb_s2_update(uint8_t crc, uint8_t byte);
+uint8_t crc8_dvb_s2(const void* buf, uint8_t len);
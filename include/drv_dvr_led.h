@@ -21,10 +21,14 @@
 //     arg1 = 0
 //     src  = SRC_DVR_LED
 //     reason = EVR_CLASSIFIER_STABLE
+//     t_ms = when the classifier decided the pattern (millis domain), not
+//            the poll that reported it
 //
 // Notes:
-//   - This module does NOT own ISR/attachInterrupt directly (that’s in dvr_led_init()).
+//   - This module does NOT own the INT1 ISR directly (that’s in dvr_led.cpp).
 //   - No buffering: emits only on accepted changes (after stability filtering).
+//   - Stability filtering is time-based (T_LED_BRIDGE_HOLD_MS / _GAP_MS on the
+//     classifier's change time), independent of loop() rate.
 // =============================================================================
 
 void drv_dvr_led_init(void);
@@ -36,3 +40,9 @@ void drv_dvr_led_poll(uint32_t now_ms);
 // Optional observability for debug/tests
 dvr_led_pattern_t drv_dvr_led_last_pattern(void);
 uint32_t drv_dvr_led_last_change_ms(void);
+
+// FAST burst in progress: true while both the last report and the classifier
+// (which may already be deciding the next pattern) are FAST_BLINK.
+//   edges  = LED edges since FAST committed (saturates at 255)
+//   age_ms = now_ms - classifier time FAST was reported
+bool drv_dvr_led_fast_burst(uint32_t now_ms, uint8_t* edges, uint32_t* age_ms);
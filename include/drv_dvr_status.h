@@ -12,13 +12,17 @@
 // Responsibility:
 //   - Consumes EV_DVR_LED_PATTERN_CHANGED from event_queue
 //   - Derives higher-level DVR semantic events
-//   - Implements SD card error discriminator (persistent FAST_BLINK)
+//   - Implements SD card error discriminator (FAST_BLINK that is not a
+//     bounded shutdown burst; see T_CARD_ERR_* in timings.h)
 //
 // This module does NOT:
 //   - Touch GPIO
 //   - Read hardware directly
 //   - Re-run the LED classifier
 //
+// Reads (no ownership): drv_dvr_led_fast_burst() for the burst bounds.
+// Commanded and DVR-initiated shutdowns are judged alike.
+//
 // Call order in main loop (important):
 //
 //   drv_dvr_led_poll(now_ms);     // classifier bridge
@@ -41,6 +45,7 @@
 // Error codes expected:
 //
 //   ERR_DVR_CARD_ERROR
+//   ERR_DVR_ABNORMAL_BOOT
 //
 // =============================================================================
 
@@ -5,9 +5,45 @@
 #include <stdbool.h>
 
 #include "enums.h"
+#include "bat_cal.h"
+
+// Battery gauge over hw_adc. Readings (last_adc, event arg1) are 12-bit
+// oversampled counts, 0..4092 (= 4 x the 10-bit scale of thresholds.h),
+// ratio-corrected to AVCC = 5.00 V against the bandgap (see hw_adc.h) and
+// by the per-unit calibration in EEPROM (bat_cal.h).
+//
+// Load-aware: thresholds apply to an open-circuit estimate, the measured
+// reading plus the IR drop of the present load class (thresholds.h,
+// BAT_R_INT_MOHM / BAT_I_*_MA). The load class follows the DVR LED
+// (drv_dvr_status: OFF = unpowered, recording_assumed() = REC), falling back
+// to the controller state pushed in through drv_fuel_gauge_set_fsm_state()
+// while the pattern is UNKNOWN. Event arg1 is the estimate.
+
+enum bat_load_t : uint8_t
+{
+    BAT_LOAD_REST = 0,   // DVR unpowered (LED off)
+    BAT_LOAD_DVR_IDLE,   // DVR powered, not recording
+    BAT_LOAD_DVR_REC     // DVR recording
+};
 
 void drv_fuel_gauge_init(void);
 void drv_fuel_gauge_poll(uint32_t now_ms);
-uint16_t drv_fuel_gauge_last_adc(void);
+uint16_t drv_fuel_gauge_last_adc(void);     // measured (terminal under load)
+uint16_t drv_fuel_gauge_est_adc(void);      // open-circuit estimate
+uint16_t drv_fuel_gauge_vcc_mv(void);       // AVCC from the last trusted bandgap
+bat_load_t drv_fuel_gauge_load(void);
 battery_state_t drv_fuel_gauge_last_state(void);
-bool drv_fuel_gauge_lockout_active(void);
\ No newline at end of file
+bool drv_fuel_gauge_lockout_active(void);
+
+// Controller state, for the load class before the DVR LED is classified.
+// Called by the controller on every state change.
+void drv_fuel_gauge_set_fsm_state(controller_state_t st);
+
+// Bench calibration: the battery input is held at pack_mv (PSU on +BAT).
+// A point >= BAT_CAL_SPAN_MIN_MV from the previous one this session solves
+// gain + offset, otherwise gain only. Saved to EEPROM and applied at once.
+// Returns false (nothing changed) before the first sample or when the fit is
+// outside the plausible spread. Blocks for the EEPROM write.
+bool drv_fuel_gauge_cal_point(uint16_t pack_mv);
+void drv_fuel_gauge_cal_clear(void);
+void drv_fuel_gauge_cal_get(bat_cal_t* out);
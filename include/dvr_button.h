@@ -8,4 +8,7 @@
 void button_init(void);
 void button_poll(uint32_t now_ms);
 bool     button_is_pressed(void);
-uint16_t button_last_press_ms(void);
\ No newline at end of file
+uint16_t button_last_press_ms(void);
+
+// Edges the INT0 capture ring had no room for (saturating)
+uint16_t button_dropped_edges(void);
\ No newline at end of file
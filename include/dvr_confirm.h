@@ -0,0 +1,74 @@
+// dvr_confirm.h
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "enums.h"
+
+// =============================================================================
+// dvr_confirm (closed-loop DVR gesture confirmation)
+// -----------------------------------------------------------------------------
+// Pairs each DVR button gesture the FSM issues with the LED pattern it should
+// produce, and asks for a bounded re-press when the DVR showed no reaction:
+//
+//   gesture          press   expected LED    deadline (from issue)
+//   REC_START        short   SLOW_BLINK      T_CONFIRM_REC_START_MS
+//   REC_STOP         short   SOLID           T_CONFIRM_REC_STOP_MS
+//   POWER_ON         long    SOLID           T_CONFIRM_POWER_ON_MS
+//   POWER_OFF        long    OFF             T_CONFIRM_POWER_OFF_MS
+//
+// Retry rule: at the deadline, re-press only if the LED did not move at all
+// since the gesture was issued: no LED edge and no reported pattern change
+// (the press did not register). If the LED was already blinking when the
+// gesture was issued (REC_STOP, POWER_OFF while recording), its own edges
+// prove nothing: only a pattern change, or the classifier seeing the blink
+// end, counts as a reaction. A DVR that reacted, but differently, is left to
+// the FSM's own handling (errors, boot timeout): re-pressing a power toggle
+// it *did* see would undo it; it gets one more window to settle before
+// counting as failed.
+// At most CFG_DVR_CONFIRM_RETRIES re-presses per gesture.
+//
+// Observes drv_dvr_status_last_led_pattern(), dvr_led_get_pattern() and
+// dvr_led_edge_count(); owns no GPIO and no queues.
+// The FSM issues the actual press for a retry (so actions keep one producer).
+//
+// Call from main loop (controller_fsm does this):
+//   dvr_confirm_start(now_ms, g);        // right after queueing the press
+//   g = dvr_confirm_poll(now_ms);        // != DVR_GEST_NONE => press g again
+// =============================================================================
+
+enum dvr_gesture_t : uint8_t
+{
+    DVR_GEST_NONE = 0,
+    DVR_GEST_REC_START,
+    DVR_GEST_REC_STOP,
+    DVR_GEST_POWER_ON,
+    DVR_GEST_POWER_OFF
+};
+
+typedef struct
+{
+    uint16_t issued;      // gestures started
+    uint16_t confirmed;   // expected LED pattern seen before giving up
+    uint16_t retries;     // automatic re-presses
+    uint16_t failed;      // retries spent, or DVR reacted but never reached the pattern
+} dvr_confirm_stats_t;
+
+void dvr_confirm_init(void);
+
+// Track a gesture that was just queued. Replaces any gesture in flight.
+void dvr_confirm_start(uint32_t now_ms, dvr_gesture_t g);
+
+// Drop the gesture in flight without counting it (lockout, user override).
+void dvr_confirm_cancel(void);
+
+// Returns the gesture to press again, or DVR_GEST_NONE.
+dvr_gesture_t dvr_confirm_poll(uint32_t now_ms);
+
+// True for gestures that are long presses (power toggles).
+bool dvr_confirm_is_long(dvr_gesture_t g);
+
+// Readbacks (telemetry)
+dvr_gesture_t dvr_confirm_pending(void);
+void          dvr_confirm_get_stats(dvr_confirm_stats_t* out);
@@ -19,7 +19,10 @@
 //     DVR_LED_SOLID
 //     DVR_LED_SLOW_BLINK
 //     DVR_LED_FAST_BLINK
+//     DVR_LED_ABNORMAL_BOOT   (short slow burst that settles OFF)
 //     DVR_LED_UNKNOWN
+//   Patterns come from a flash signature table in dvr_led.cpp (period,
+//   ON/OFF windows, burst length, terminal level).
 //
 // IMPORTANT (RunCam behaviour):
 // - FAST_BLINK is *not* uniquely "shutdown".
@@ -28,14 +31,68 @@
 //
 // API contract:
 // - dvr_led_init():
-//     Configure GPIO + attachInterrupt(), reset internal classifier state.
+//     Configure GPIO + INT1 (any change), reset internal classifier state.
+//     Requires hw_timer_init() first (edges are timestamped with Timer1).
 // - dvr_led_poll(now_ms):
-//     Drain ISR edge buffer, update classifier, apply quiet-time transitions.
-//     Call frequently from loop().
+//     Drain ISR edge buffer (ring mode), update classifier, apply quiet-time
+//     transitions. Call frequently from loop(). With
+//     CFG_DVR_LED_ISR_CLASSIFIER the classifier runs inside INT1 and this
+//     only performs the quiet-time check.
 // - dvr_led_get_pattern():
 //     Current classified pattern (sticky blink until quiet-time).
+// - dvr_led_get_pattern_since(&since_tk):
+//     Same, plus the Timer1 time the pattern was decided: the committing
+//     edge, or the moment the quiet deadline passed (independent of how
+//     often dvr_led_poll() runs). Read atomically with the pattern.
+// - dvr_led_get_confidence():
+//     0..255 support for the current pattern. For blink: the pattern's
+//     decaying likelihood score (each matching period adds, any other period
+//     decays by 1/4; commit at 120 = two hits). 255 for quiet-time
+//     SOLID/OFF/ABNORMAL_BOOT, 0 for UNKNOWN. drv_dvr_led only reports
+//     changes at or above CFG_DVR_LED_EMIT_MIN_CONF.
+// - dvr_led_blink_edges():
+//     LED edges seen since the current SLOW/FAST blink committed (saturates
+//     at 255, 0 when not blinking). Lets drv_dvr_led_fast_burst() bound a
+//     burst by flash count, not just by time.
+// - dvr_led_edge_count():
+//     Free-running (wrapping) count of LED edges the classifier has seen.
+//     Compare two readings to tell "the LED moved" before any pattern
+//     commits (dvr_confirm uses it to see a press registered).
+// - dvr_led_note_toggle_press():
+//     Called by the actuator when it starts a record-toggle (short) press.
+//     Used as a prior: with CFG_DVR_LED_FAST_COMMIT, one tight ON+OFF pair
+//     completing within T_LED_PRESS_PRIOR_MS commits SLOW_BLINK without
+//     waiting for a second period.
+// - dvr_led_dropped_edges():
+//     Edges lost to ring overflow since init (saturating). The classifier
+//     sees a GAP marker at each loss and restarts period tracking instead of
+//     measuring across it.
+// - dvr_led_storm_active() / dvr_led_storm_trips():
+//     With CFG_DVR_LED_STORM_GUARD, more than 8 INT1 entries within 20 ms
+//     masks INT1 and samples the line at 1 kHz on Timer2 (3-sample majority)
+//     until a 500 ms window is clean. Timer2 is owned by this module while
+//     a storm is active. trips = storms entered since init (saturating).
+// - dvr_led_cal_get(slot, &on_ms, &off_ms) / dvr_led_cal_clear():
+//     With CFG_DVR_LED_SELF_CAL, 16 steady pairs of a confirmed FAST (slot 0)
+//     or SLOW (slot 1) blink are averaged into ON/OFF centres. The single-pair
+//     SLOW press-commit envelope becomes centre +-1/8 (instead of
+//     T_SLOW_FAST_*); matching itself stays on the compiled windows, so a
+//     different DVR is still recognised and re-learned. The centres are
+//     persisted via led_cal (EEPROM + CRC8).
+//     get() returns false while a slot is still on compiled defaults.
+//     clear() drops the learned values and invalidates the EEPROM record.
 // =============================================================================
 
 void dvr_led_init(void);
 void dvr_led_poll(uint32_t now_ms);
 dvr_led_pattern_t dvr_led_get_pattern(void);
+dvr_led_pattern_t dvr_led_get_pattern_since(uint32_t* since_tk);
+uint8_t dvr_led_get_confidence(void);
+uint8_t dvr_led_blink_edges(void);
+uint16_t dvr_led_edge_count(void);
+void dvr_led_note_toggle_press(void);
+uint16_t dvr_led_dropped_edges(void);
+bool dvr_led_storm_active(void);
+uint16_t dvr_led_storm_trips(void);
+bool dvr_led_cal_get(uint8_t slot, uint16_t* on_ms, uint16_t* off_ms);
+void dvr_led_cal_clear(void);
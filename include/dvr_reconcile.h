@@ -0,0 +1,66 @@
+// dvr_reconcile.h
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "enums.h"
+#include "dvr_confirm.h"
+
+// =============================================================================
+// dvr_reconcile (commanded vs LED-observed DVR state)
+// -----------------------------------------------------------------------------
+// Three views of the DVR exist:
+//   intent   : what the user last asked for (set from every DVR gesture the
+//              FSM issues; adopts physical-button record toggles)
+//   belief   : controller_fsm state (OFF / IDLE / RECORDING)
+//   observed : settled LED pattern from drv_dvr_status (OFF / SOLID / SLOW)
+// drv_dvr_status_recording_assumed() is LED-derived, i.e. already "observed".
+//
+// Each poll, once our own gestures have settled (dvr_confirm idle) and the
+// LED has stood T_RECONCILE_SETTLE_MS, drift is fixed with the least action:
+//
+//   belief != observed      -> ADOPT: FSM takes the observed state, no press.
+//                              (Next user press then does what they meant,
+//                              instead of a power toggle on a running DVR.)
+//   SOLID <-> SLOW directly -> physical record button: intent follows it.
+//   ON -> OFF/other -> SOLID within T_RECONCILE_REBOOT_MS while intent was
+//   RECORDING               -> the DVR rebooted under us: one REC_START press.
+//
+// Never issues a power gesture: a DVR that went OFF on its own stays OFF (it
+// may be the user's own power-off), and nothing is ever fixed by cycling
+// through OFF.
+// =============================================================================
+
+enum dvr_view_t : uint8_t
+{
+    DVR_VIEW_UNKNOWN = 0,   // transitional / error pattern: do not reconcile
+    DVR_VIEW_OFF,
+    DVR_VIEW_IDLE,
+    DVR_VIEW_RECORDING
+};
+
+typedef struct
+{
+    dvr_view_t    adopt;     // != UNKNOWN => FSM should take this state
+    dvr_gesture_t gesture;   // != NONE    => FSM should issue this gesture
+} dvr_reconcile_fix_t;
+
+typedef struct
+{
+    uint16_t adopted;     // FSM belief corrected to the LED
+    uint16_t followed;    // physical record toggles adopted into intent
+    uint16_t restored;    // REC_START presses after an unplanned reboot
+} dvr_reconcile_stats_t;
+
+void dvr_reconcile_init(void);
+
+// Intent follows every gesture the FSM issues (call alongside dvr_confirm_start).
+void dvr_reconcile_note_gesture(dvr_gesture_t g);
+
+// Returns true when *out holds a fix to apply. fsm_state is the FSM's belief.
+bool dvr_reconcile_poll(uint32_t now_ms, controller_state_t fsm_state, dvr_reconcile_fix_t* out);
+
+// Readbacks (telemetry)
+dvr_view_t dvr_reconcile_intent(void);
+void       dvr_reconcile_get_stats(dvr_reconcile_stats_t* out);
@@ -31,7 +31,10 @@ enum event_id_t : uint8_t
     EV_DVR_RECORD_STARTED,
     EV_DVR_RECORD_STOPPED,
     EV_DVR_POWERED_OFF,
-    EV_DVR_ERROR                  // arg0=error_code_t, arg1=detail (e.g. last pattern)
+    EV_DVR_ERROR,                 // arg0=error_code_t, arg1=detail (e.g. last pattern)
+
+    // Appended: existing ids (logs, host tools) keep their numbers
+    EV_BAT_RUNTIME_LOW            // arg0=recording minutes left, arg1=SoC permille
 };
 
 enum event_source_t : uint8_t
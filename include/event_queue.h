@@ -5,6 +5,7 @@
 // Consumer: main loop (single thread)
 //
 // Policy: drop-new on full; increment dropped counter.
+// Exception: eventq_push_front_isr() (urgent events) displaces the newest.
 
 #pragma once
 
@@ -39,6 +40,11 @@ bool     eventq_push(const event_t *e);
 // Safe to call from ISR; does not re-enable interrupts.
 bool     eventq_push_isr(const event_t *e);
 
+// Urgent enqueue from ISR context: the event is popped NEXT, ahead of anything
+// already queued. Always lands; if the queue is full the newest queued event
+// is discarded (counted as dropped) and false is returned.
+bool     eventq_push_front_isr(const event_t *e);
+
 // Pop one event (atomic). Returns true if one was dequeued.
 bool     eventq_pop(event_t *out);
 
@@ -0,0 +1,85 @@
+// fast_gpio.h
+//
+// Zero-overhead GPIO for fixed pins (ATmega328P, Nano/Uno pin numbering).
+//
+// fast_pin<N> resolves an Arduino pin number to its PORT/PIN/DDR register and
+// bit mask at compile time. With a constant pin every access compiles to one
+// sbi / cbi / sbis / in instruction (PORTB/C/D live in the low IO space),
+// instead of digitalRead()/digitalWrite()'s table lookups, PWM-off check and
+// SREG save (~50-70 cycles each).
+//
+// Mapping (ATmega328P):
+//   D0..D7   -> PORTD bit 0..7
+//   D8..D13  -> PORTB bit 0..5
+//   D14..D19 -> PORTC bit 0..5   (A0..A5)
+//
+// Notes:
+// - Single-bit sbi/cbi are atomic; no ATOMIC_BLOCK needed even if an ISR
+//   writes another bit of the same port.
+// - Does not disconnect timer PWM from the pin. Pins driven through here must
+//   never be used with analogWrite() (none are in this firmware).
+// - Pin descriptors for this board live in pins.h (pin_*_t typedefs).
+
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __AVR__
+  #include <avr/io.h>
+#endif
+
+template <uint8_t Pin>
+struct fast_pin
+{
+    static_assert(Pin < 20, "fast_pin: not an ATmega328P digital pin");
+
+    static constexpr uint8_t bit  = (Pin < 8) ? Pin : ((Pin < 14) ? (uint8_t)(Pin - 8) : (uint8_t)(Pin - 14));
+    static constexpr uint8_t mask = (uint8_t)(1u << bit);
+
+#ifdef __AVR__
+    static inline volatile uint8_t& port_reg() { return (Pin < 8) ? PORTD : ((Pin < 14) ? PORTB : PORTC); }
+    static inline volatile uint8_t& pin_reg()  { return (Pin < 8) ? PIND  : ((Pin < 14) ? PINB  : PINC);  }
+    static inline volatile uint8_t& ddr_reg()  { return (Pin < 8) ? DDRD  : ((Pin < 14) ? DDRB  : DDRC);  }
+#endif
+
+    // Outputs
+    static inline void high(void)
+    {
+#ifdef __AVR__
+        port_reg() |= mask;
+#endif
+    }
+
+    static inline void low(void)
+    {
+#ifdef __AVR__
+        port_reg() &= (uint8_t)~mask;
+#endif
+    }
+
+    static inline void toggle(void)
+    {
+#ifdef __AVR__
+        pin_reg() = mask;   // PINx write toggles PORTx bit
+#endif
+    }
+
+    // level: HIGH / LOW (Arduino constants, usually compile-time)
+    static inline void write(uint8_t level)
+    {
+        if (level) high();
+        else       low();
+    }
+
+    // Inputs
+    static inline uint8_t read_raw(void)   // non-boolean
+    {
+#ifdef __AVR__
+        return (uint8_t)(pin_reg() & mask);
+#else
+        return 0;
+#endif
+    }
+
+    static inline uint8_t read(void) { return read_raw() ? 1u : 0u; }   // HIGH / LOW
+};
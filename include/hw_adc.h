@@ -0,0 +1,84 @@
+// hw_adc.h
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __AVR__
+  #include <avr/io.h>
+#endif
+
+// =============================================================================
+// hw_adc (auto-triggered, ISR-oversampled battery ADC)
+// -----------------------------------------------------------------------------
+// The ADC converts PIN_FUELGAUGE_ADC (ADC0, AVCC reference) on every Timer0
+// overflow (auto-trigger source ADTS=100, ~976 Hz: the Arduino millis() tick,
+// whose ISR clears TOV0 so each overflow is a fresh trigger edge). ADC clock
+// is clk/128 = 125 kHz, 104 us per conversion, well inside the 1.024 ms slot.
+//
+// ADC_vect accumulates HW_ADC_OS_SAMPLES conversions and decimates:
+//   result = sum(16 x 10-bit) >> 2   => 12-bit, 0..4092, one every ~16.4 ms
+// (+2 bits of effective resolution for noise-dithered input).
+//
+// Supply tracking: every HW_ADC_BG_EVERY batches the mux switches to the
+// internal 1.1 V bandgap for one slot (1 settling conversion thrown away,
+// HW_ADC_BG_SAMPLES summed, 1 settling conversion on the way back):
+//   bg = sum(4 x 10-bit)  => 12-bit scale, 900 at AVCC = 5.00 V
+//   AVCC = 1.1 V x 4092 / bg,  ratio-corrected battery = adc x 900 / bg
+// Costs 6 of every 70 conversion slots (battery batch ~17.9 ms on average).
+// The bandgap itself is 1.0..1.2 V chip to chip: this tracks AVCC drift, the
+// absolute error is a per-unit gain term.
+//
+// Main loop never waits on a conversion: hw_adc_take() returns the newest
+// result once per batch, or false if none finished since the last take.
+//
+// Threshold trip (fast path for the battery lockout): ADC_vect also runs
+// every raw 10-bit battery conversion through an EMA (1/8 per conversion,
+// ~8 ms time constant) and compares the filtered value against an armed
+// level. After `conversions` consecutive filtered values at or below it the
+// trip disarms itself and calls the hook FROM ADC_vect (interrupts disabled:
+// keep it short, ISR-safe calls only). The filter is re-seeded on arm.
+// Detection latency is filter lag + conversions x ~1.02 ms; hook entry
+// follows the last conversion by a few us. A dip shorter than that run
+// (load inrush) cannot trip, however deep. The analog comparator is not an
+// option here: both of its inputs (AIN0/PD6, AIN1/PD7) are outputs on this
+// board.
+//
+// Ownership:
+//   - The ADC, its mux and ADC_vect are owned by this module. Do NOT call analogRead()
+//     anywhere once hw_adc_init() has run.
+//   - Timer0 is only read as a trigger source (its configuration is untouched).
+// =============================================================================
+
+#define HW_ADC_OS_SAMPLES   16u   // conversions per result
+#define HW_ADC_OS_SHIFT     2u    // sum >> 2 => 12-bit
+#define HW_ADC_MAX          4092u // 16 * 1023 >> 2
+
+#define HW_ADC_BG_EVERY     4u    // battery batches between bandgap slots (~70 ms)
+#define HW_ADC_BG_SAMPLES   4u    // bandgap conversions summed => 12-bit
+#define HW_ADC_BG_NOMINAL   900u  // 1.1 V at AVCC 5.00 V (1100 * 4092 / 5000)
+#define HW_ADC_BG_MIN       818u  // AVCC 5.5 V; outside => reading not trusted
+#define HW_ADC_BG_MAX       1125u // AVCC 4.0 V
+
+#define HW_ADC_TRIP_EMA_SHIFT 3u  // trip filter: 1/8 per conversion (1023 x 8 fits)
+
+void hw_adc_init(void);
+
+// Newest 12-bit result if a batch finished since the last call.
+bool hw_adc_take(uint16_t* out);
+
+// Last bandgap sum (12-bit scale), 0 until the first slot completes (~70 ms).
+uint16_t hw_adc_bandgap(void);
+
+// raw = the filtered 10-bit value that completed the trip
+typedef void (*hw_adc_trip_fn)(uint16_t raw);
+
+// One-shot; re-arming replaces any armed trip, restarts the count and
+// re-seeds the filter.
+void hw_adc_trip_arm(uint16_t level, uint8_t conversions, hw_adc_trip_fn fn);
+
+// Move an armed trip's level without restarting its count.
+void hw_adc_trip_set_level(uint16_t level);
+
+// Returns true if the trip was still armed (it had not fired).
+bool hw_adc_trip_disarm(void);
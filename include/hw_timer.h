@@ -0,0 +1,88 @@
+// hw_timer.h
+#pragma once
+
+#include <stdint.h>
+
+#ifdef __AVR__
+  #include <avr/io.h>
+  #include <avr/interrupt.h>
+#endif
+
+// =============================================================================
+// hw_timer (Timer1 free-running timestamp counter)
+// -----------------------------------------------------------------------------
+// Timer1 runs in normal mode, prescaler 8 => 2 MHz (0.5 us per tick, 8 CPU
+// cycles per tick at 16 MHz). The 16-bit counter wraps every 32.768 ms.
+//
+// A TIMER1_OVF ISR (one 16-bit increment every 32.768 ms) extends the count
+// to 32 bits (wraps after ~35.8 minutes; differences stay valid).
+//
+// Ownership:
+//   - Timer1 and its overflow vector are owned by this module. Do NOT analogWrite() on D9/D10 and do
+//     not use libraries that reconfigure Timer1 (Servo, TimerOne, ...).
+//   - PIN_KILL_N_O (D9 / OC1A) is driven as plain GPIO, which is unaffected.
+//
+// Usage:
+//   hw_timer_init();                       // once, in setup()
+//   const uint16_t t0 = hw_timer_now16();
+//   ...
+//   const uint16_t dt = hw_timer_now16() - t0;   // wrap-safe for < 32.7 ms
+//
+//   hw_timer_now16() / hw_timer_now32()           // main context (atomic read)
+//   hw_timer_now16_isr() / hw_timer_now32_isr()   // interrupts already disabled (ISR bodies)
+// =============================================================================
+
+#define HW_TIMER_TICKS_PER_US     2u
+#define HW_TIMER_CYCLES_PER_TICK  8u
+#define HW_TIMER_TICKS_PER_MS     2000u
+
+// Overflow count = high 16 bits of the extended timestamp (ISR-owned)
+extern volatile uint16_t g_hw_timer_ovf;
+
+void hw_timer_init(void);
+
+// Raw 16-bit tick count. Caller guarantees interrupts are disabled (ISR
+// context).
+static inline uint16_t hw_timer_now16_isr(void)
+{
+#ifdef __AVR__
+    return TCNT1;
+#else
+    return 0;
+#endif
+}
+
+// Raw 16-bit tick count from main-loop context. Reading TCNT1 latches the high
+// byte into the TEMP register every 16-bit Timer1 access shares; an ISR that
+// reads TCNT1 or writes OCR1B between the two byte reads would overwrite it,
+// so interrupts are held off for the read (~4 cycles).
+static inline uint16_t hw_timer_now16(void)
+{
+#ifdef __AVR__
+    const uint8_t sreg = SREG;
+    cli();
+    const uint16_t t = TCNT1;
+    SREG = sreg;
+    return t;
+#else
+    return 0;
+#endif
+}
+
+// Extended 32-bit tick count. Caller guarantees interrupts are disabled
+// (ISR context). Accounts for an overflow that is pending but not yet serviced.
+static inline uint32_t hw_timer_now32_isr(void)
+{
+#ifdef __AVR__
+    const uint16_t lo = TCNT1;
+    uint16_t hi = g_hw_timer_ovf;
+    if ((TIFR1 & _BV(TOV1)) && lo < 0x8000u)
+        hi++;
+    return ((uint32_t)hi << 16) | lo;
+#else
+    return 0;
+#endif
+}
+
+// Extended 32-bit tick count from main-loop context.
+uint32_t hw_timer_now32(void);
@@ -0,0 +1,72 @@
+// isr_stats.h
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+#include "hw_timer.h"
+
+// =============================================================================
+// isr_stats (interrupt latency / duration instrumentation)
+// -----------------------------------------------------------------------------
+// Two measurements, both in Timer1 ticks (0.5 us / 8 CPU cycles):
+//
+// 1) Entry-latency probe (Timer1 COMPB)
+//    A compare match is scheduled kProbePeriodTk ticks after each probe ran
+//    (re-armed from TCNT1: a stall longer than the period cannot silence it
+//    for a 32 ms Timer1 wrap). The probe ISR reads TCNT1 - OCR1B, i.e. how
+//    long after the hardware request the vector actually ran. Whenever a
+//    probe request lands inside a cli()/ATOMIC_BLOCK or another ISR, that
+//    window shows up as latency, so:
+//      lat_max_tk  ~= longest interrupts-disabled window in the firmware
+//                     (+ fixed vector/prologue cost, ~2 ticks)
+//    Any other interrupt (INT1 included) sees the same latency distribution,
+//    which bounds the timestamp error of LED edges.
+//
+// 2) INT1 (DVR LED sniffer) handler duration
+//    ISR_STATS_INT1_ENTER()/EXIT() bracket the INT1 vector body. The
+//    compiler-generated register save/restore is outside the bracket.
+//
+// Counters are readable via isr_stats_get() and reported over telemetry ('i').
+// With CFG_ISR_STATS == 0 the macros are empty and Timer1 COMPB stays unused.
+// =============================================================================
+
+typedef struct
+{
+    uint16_t probe_count;        // saturating
+    uint16_t lat_max_tk;         // worst probe entry latency (IRQ-off window)
+    uint16_t lat_avg_tk;         // running average probe latency
+    uint16_t int1_count;         // saturating
+    uint16_t int1_dur_max_tk;    // longest INT1 handler body
+    uint16_t int1_dur_last_tk;   // most recent INT1 handler body
+} isr_stats_t;
+
+#if CFG_ISR_STATS
+
+void isr_stats_init(void);
+void isr_stats_reset(void);
+void isr_stats_get(isr_stats_t *out);
+
+// INT1 duration bookkeeping (ISR context only; kept inline for cost)
+extern volatile uint16_t g_isr_int1_count;
+extern volatile uint16_t g_isr_int1_dur_max_tk;
+extern volatile uint16_t g_isr_int1_dur_last_tk;
+
+static inline void isr_stats_int1_done(uint16_t t0)
+{
+    const uint16_t dur = (uint16_t)(hw_timer_now16_isr() - t0);
+
+    g_isr_int1_dur_last_tk = dur;
+    if (dur > g_isr_int1_dur_max_tk) g_isr_int1_dur_max_tk = dur;
+    if (g_isr_int1_count != 0xFFFFu) g_isr_int1_count++;
+}
+
+  #define ISR_STATS_INT1_ENTER()  const uint16_t isr_stats_t0_ = hw_timer_now16_isr()
+  #define ISR_STATS_INT1_EXIT()   isr_stats_int1_done(isr_stats_t0_)
+
+#else
+
+  #define ISR_STATS_INT1_ENTER()  do { } while (0)
+  #define ISR_STATS_INT1_EXIT()   do { } while (0)
+
+#endif
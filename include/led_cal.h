@@ -0,0 +1,40 @@
+// led_cal.h
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// led_cal (DVR LED timing calibration record, EEPROM)
+// -----------------------------------------------------------------------------
+// Persists the ON/OFF half durations dvr_led learned from the attached DVR,
+// one slot per calibratable signature row.
+//
+// Record at CFG_EE_LED_CAL_ADDR:
+//   [version][slot0.on][slot0.off][slot1.on][slot1.off][crc8]
+//   durations are uint16_t in 128 us classifier units, 0 = not learned
+//   crc8 = CRC-8/DVB-S2 over version + slots
+//
+// A blank, stale-version or corrupt record loads as "nothing learned", so the
+// classifier falls back to the compiled timings.h windows.
+//
+// Writes use eeprom_update_block() (unchanged bytes are not rewritten) and
+// block for a few ms per changed byte: call from loop(), never from an ISR.
+// =============================================================================
+
+#define LED_CAL_SLOTS      2u    // 0 = FAST_BLINK row, 1 = SLOW_BLINK row
+#define LED_CAL_RECORD_LEN 10u   // bytes used at CFG_EE_LED_CAL_ADDR
+
+typedef struct
+{
+    uint16_t on_u;    // LED-ON half, 128 us units (0 = not learned)
+    uint16_t off_u;   // LED-OFF half
+} led_cal_slot_t;
+
+// Fills slots from EEPROM. Returns false (and zeroes slots) if no valid record.
+bool led_cal_load(led_cal_slot_t slots[LED_CAL_SLOTS]);
+
+void led_cal_save(const led_cal_slot_t slots[LED_CAL_SLOTS]);
+
+// Invalidate the record (next boot uses compiled defaults).
+void led_cal_erase(void);
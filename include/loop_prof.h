@@ -0,0 +1,98 @@
+// loop_prof.h
+#pragma once
+
+#include <stdint.h>
+
+#include "config.h"
+#include "hw_timer.h"
+
+// =============================================================================
+// loop_prof (per-stage main-loop profiler)
+// -----------------------------------------------------------------------------
+// Timestamps each loop() stage with the Timer1 free-running counter
+// (hw_timer.h, 0.5 us / 8 CPU cycles per tick) and keeps, per stage:
+//   - min / max / running average (ticks)
+//   - an 8-bin log histogram, two octaves per bin (ticks):
+//       bin0 = 0, bin1 < 4, bin2 < 16, bin3 < 64, bin4 < 256,
+//       bin5 < 1024, bin6 < 4096, bin7 >= 4096 (2 ms+)
+//
+// Cost model:
+//   - PROF_STAGE() is one TCNT1 read with interrupts held off (hw_timer_now16)
+//     + one subtract + two stores (~14 cycles).
+//   - Statistics are folded once per loop in PROF_LOOP_END(), after the last
+//     stage, so fold cost is never charged to any stage. The average is only
+//     divided out on readback (loop_prof_get), never in the loop.
+//
+// Compile-time removable: with CFG_LOOP_PROFILER == 0 every macro is empty and
+// the module contributes no code or RAM.
+//
+// Stage durations must stay below one Timer1 wrap (32.7 ms) to be exact;
+// longer stages alias (they land in bin7 with a wrapped value).
+//
+// Usage in loop():
+//   PROF_LOOP_BEGIN();
+//   button_poll(now);           PROF_STAGE(PROF_ST_BUTTON);
+//   ...
+//   executor_poll(now);         PROF_STAGE(PROF_ST_EXECUTOR);
+//   PROF_LOOP_END();
+// =============================================================================
+
+enum prof_stage_t : uint8_t
+{
+    PROF_ST_BUTTON = 0,
+    PROF_ST_FUEL_GAUGE,
+    PROF_ST_DVR_LED,
+    PROF_ST_DVR_STATUS,
+    PROF_ST_OBSERVE,
+    PROF_ST_TELEMETRY,
+    PROF_ST_FSM,
+    PROF_ST_EXECUTOR,
+
+    PROF_STAGE_COUNT
+};
+
+#define PROF_HIST_BINS  8
+
+typedef struct
+{
+    uint16_t min_tk;
+    uint16_t max_tk;
+    uint16_t avg_tk;
+    uint16_t samples;                 // saturating
+    uint16_t hist[PROF_HIST_BINS];    // saturating
+} prof_stat_t;
+
+#if CFG_LOOP_PROFILER
+
+void loop_prof_init(void);
+void loop_prof_reset(void);
+void loop_prof_fold(void);
+bool loop_prof_get(uint8_t stage, prof_stat_t *out);
+
+// Hot-path state (kept extern so the marks inline to a few instructions)
+extern uint16_t g_prof_t_prev;
+extern uint16_t g_prof_dt[PROF_STAGE_COUNT];
+
+static inline void loop_prof_begin(void)
+{
+    g_prof_t_prev = hw_timer_now16();
+}
+
+static inline void loop_prof_mark(uint8_t stage)
+{
+    const uint16_t t = hw_timer_now16();
+    g_prof_dt[stage] = (uint16_t)(t - g_prof_t_prev);
+    g_prof_t_prev    = t;
+}
+
+  #define PROF_LOOP_BEGIN()   loop_prof_begin()
+  #define PROF_STAGE(st)      loop_prof_mark((uint8_t)(st))
+  #define PROF_LOOP_END()     loop_prof_fold()
+
+#else
+
+  #define PROF_LOOP_BEGIN()   do { } while (0)
+  #define PROF_STAGE(st)      do { } while (0)
+  #define PROF_LOOP_END()     do { } while (0)
+
+#endif
@@ -0,0 +1,30 @@
+// mem_stats.h
+#pragma once
+
+#include <stdint.h>
+
+// =============================================================================
+// mem_stats (SRAM budget / stack high-watermark)
+// -----------------------------------------------------------------------------
+// At reset (.init1, before .data/.bss are initialised) every byte between the
+// end of static RAM (_end) and the top of the stack (RAMEND) is painted with
+// a canary. The stack grows down into that region; the lowest overwritten
+// byte marks the deepest stack excursion since boot.
+//
+// The painter runs unconditionally (it costs ~12 words of flash and a few
+// hundred microseconds at reset). Queries scan the painted gap and are meant
+// for on-demand diagnostics (telemetry 'm'), not for the hot path.
+//
+// Assumes no heap use (no malloc/String). If the heap is used, heap blocks
+// overwrite the canary from below and are counted as "used".
+// =============================================================================
+
+typedef struct
+{
+    uint16_t static_bytes;   // .data + .bss (+ .noinit)
+    uint16_t stack_peak;     // deepest stack use since boot (bytes)
+    uint16_t stack_now;      // current stack depth (bytes)
+    uint16_t never_used;     // painted bytes still untouched (headroom)
+} mem_stats_t;
+
+void mem_stats_get(mem_stats_t *out);
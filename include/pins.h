@@ -15,6 +15,8 @@
 
 #include <Arduino.h>
 
+#include "fast_gpio.h"
+
 // -----------------------------------------------------------------------------
 // Arduino pin numbers (portable across Nano / ATmega328P core)
 // -----------------------------------------------------------------------------
@@ -70,22 +72,36 @@
 #define LTC_INT_DEASSERT_LEVEL HIGH
 
 // -----------------------------------------------------------------------------
-// Fast direct-port helpers (optional, but handy for tight edge timing)
+// Compile-time pin descriptors (see fast_gpio.h)
+// Single sbi/cbi/in per access; use these on every hot path.
+// -----------------------------------------------------------------------------
+typedef fast_pin<PIN_LTC_INT_N>    pin_ltc_int_t;
+typedef fast_pin<PIN_DVR_STAT>     pin_dvr_stat_t;
+typedef fast_pin<PIN_BUZZER_OUT>   pin_buzzer_t;
+typedef fast_pin<PIN_STATUS_LED>   pin_status_led_t;
+typedef fast_pin<PIN_DVR_BTN_CMD>  pin_dvr_btn_t;
+typedef fast_pin<PIN_KILL_N_O>     pin_kill_t;
+
 // -----------------------------------------------------------------------------
-#define DVR_STAT_READ()        (PIND & _BV(PD3))          // raw port read (non-boolean)
-#define LTC_INT_READ()         (PIND & _BV(PD2))
+// Fast direct-port helpers
+// -----------------------------------------------------------------------------
+#define DVR_STAT_READ()        (pin_dvr_stat_t::read_raw())   // raw port read (non-boolean)
+#define LTC_INT_READ()         (pin_ltc_int_t::read_raw())
+
+#define DVR_STAT_LEVEL()       (pin_dvr_stat_t::read())       // HIGH / LOW
+#define LTC_INT_LEVEL()        (pin_ltc_int_t::read())
 
-#define STATUS_LED_ON()        do { digitalWrite(PIN_STATUS_LED, STATUS_LED_ON_LEVEL); } while (0)
-#define STATUS_LED_OFF()       do { digitalWrite(PIN_STATUS_LED, STATUS_LED_OFF_LEVEL); } while (0)
+#define STATUS_LED_ON()        do { pin_status_led_t::write(STATUS_LED_ON_LEVEL); } while (0)
+#define STATUS_LED_OFF()       do { pin_status_led_t::write(STATUS_LED_OFF_LEVEL); } while (0)
 
-#define BUZZER_ON()            do { digitalWrite(PIN_BUZZER_OUT, BUZZER_ON_LEVEL); } while (0)
-#define BUZZER_OFF()           do { digitalWrite(PIN_BUZZER_OUT, BUZZER_OFF_LEVEL); } while (0)
+#define BUZZER_ON()            do { pin_buzzer_t::write(BUZZER_ON_LEVEL); } while (0)
+#define BUZZER_OFF()           do { pin_buzzer_t::write(BUZZER_OFF_LEVEL); } while (0)
 
-#define DVR_BTN_PRESS()        do { digitalWrite(PIN_DVR_BTN_CMD, DVR_BTN_PRESS_LEVEL); } while (0)
-#define DVR_BTN_RELEASE()      do { digitalWrite(PIN_DVR_BTN_CMD, DVR_BTN_RELEASE_LEVEL); } while (0)
+#define DVR_BTN_PRESS()        do { pin_dvr_btn_t::write(DVR_BTN_PRESS_LEVEL); } while (0)
+#define DVR_BTN_RELEASE()      do { pin_dvr_btn_t::write(DVR_BTN_RELEASE_LEVEL); } while (0)
 
-#define KILL_ASSERT()          do { digitalWrite(PIN_KILL_N_O, KILL_ASSERT_LEVEL); } while (0)
-#define KILL_DEASSERT()        do { digitalWrite(PIN_KILL_N_O, KILL_DEASSERT_LEVEL); } while (0)
+#define KILL_ASSERT()          do { pin_kill_t::write(KILL_ASSERT_LEVEL); } while (0)
+#define KILL_DEASSERT()        do { pin_kill_t::write(KILL_DEASSERT_LEVEL); } while (0)
 
 // -----------------------------------------------------------------------------
 // Centralised GPIO init (call once in setup())
@@ -0,0 +1,72 @@
+// rcdp.h
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// =============================================================================
+// rcdp (RunCam Device Protocol over the hardware UART)
+// -----------------------------------------------------------------------------
+// Low-latency DVR control path for RunCam Split modules. Record start/stop is
+// a 4-byte frame (~0.35 ms on the wire at 115200) instead of a 500 ms button
+// press; the executor falls back to contact closure whenever the link is down
+// or the camera lacks the feature.
+//
+// Frames (CRC-8/DVB-S2 over every preceding byte, crc8.h):
+//   request  GET_DEVICE_INFO : CC 00 crc
+//   response GET_DEVICE_INFO : CC ver feat_lo feat_hi crc
+//   request  CAMERA_CONTROL  : CC 01 action crc        (no response)
+//
+// Link state machine (non-blocking, rcdp_poll() from loop()):
+//   DOWN  --probe every T_RCDP_PROBE_MS-->  reply  => UP (features latched)
+//   UP    --keepalive probe-->               no reply within T_RCDP_RESP_MS => DOWN
+//   command: CAMERA_CONTROL frame immediately followed by a GET_DEVICE_INFO
+//   probe. The UART is in-order, so the reply acknowledges the command at link
+//   level (camera alive and parsing); the LED classifier still confirms state.
+//   A missing ack drops the link; dvr_confirm's retry then goes out as a press.
+//
+// Byte I/O is injected (rcdp_io_t) so the state machine can run against a
+// simulated responder; NULL selects Serial at CFG_DVR_UART_BAUD. The UART is
+// shared with debug serial: config.h refuses CFG_DVR_UART with CFG_DEBUG_SERIAL.
+// =============================================================================
+
+#define RCDP_HEADER                  0xCCu
+
+#define RCDP_CMD_GET_DEVICE_INFO     0x00u
+#define RCDP_CMD_CAMERA_CONTROL      0x01u
+
+#define RCDP_CTRL_START_RECORDING    0x03u
+#define RCDP_CTRL_STOP_RECORDING     0x04u
+
+#define RCDP_FEAT_START_RECORDING    (1u << 6)
+#define RCDP_FEAT_STOP_RECORDING     (1u << 7)
+
+typedef struct
+{
+    int16_t (*rx)(void);                           // next byte, or -1 if none
+    bool    (*tx)(const uint8_t* buf, uint8_t len); // all-or-nothing, never blocks
+} rcdp_io_t;
+
+typedef struct
+{
+    uint16_t probes;      // GET_DEVICE_INFO requests sent (incl. command acks)
+    uint16_t commands;    // CAMERA_CONTROL frames sent
+    uint16_t acks;        // commands acknowledged by the following reply
+    uint16_t timeouts;    // replies missed (link dropped)
+    uint16_t crc_errors;  // reply frames with a bad CRC
+    uint32_t last_rtt_tk; // last command -> ack round trip (Timer1 ticks, 0.5 us)
+} rcdp_stats_t;
+
+void rcdp_init(const rcdp_io_t* io);
+void rcdp_poll(uint32_t now_ms);
+
+// Camera answered the last probe
+bool     rcdp_link_up(void);
+uint16_t rcdp_features(void);
+
+// Queue a CAMERA_CONTROL action. Returns false (caller falls back to the
+// button) if the link is down, the camera lacks the feature, or a command is
+// already in flight.
+bool rcdp_request(uint8_t action);
+
+void rcdp_get_stats(rcdp_stats_t* out);
@@ -0,0 +1,36 @@
+// telemetry.h
+#pragma once
+
+#include <stdint.h>
+
+// =============================================================================
+// telemetry (on-demand diagnostics over the debug serial port)
+// -----------------------------------------------------------------------------
+// Single-character commands are read from Serial (non-blocking) and answered
+// with a short text report. Digits typed first form a decimal argument. Modules expose plain readback accessors; all
+// formatting lives here so drivers stay free of Serial.
+//
+// Commands:
+//   ?   list commands
+//   m   SRAM budget: static bytes, stack high-watermark, untouched headroom
+//   g   DVR gesture confirmation: issued / confirmed / retries / failed,
+//       reconciliation: intent / adopted / followed / restored
+//   b   battery: calibrated reading, load estimate, AVCC, SoC, recording
+//       minutes left, calibration gain/offset
+//   <mV>k  battery calibration point at a known pack voltage ("7400k");
+//       stored in EEPROM (bat_cal)
+//   K   clear battery calibration
+//   c   learned DVR LED timings          (CFG_DVR_LED_SELF_CAL)
+//   C   forget learned DVR LED timings   (CFG_DVR_LED_SELF_CAL)
+//   p   loop profiler report   (CFG_LOOP_PROFILER)
+//   P   loop profiler reset    (CFG_LOOP_PROFILER)
+//   i   ISR latency / INT1 duration report (CFG_ISR_STATS)
+//   I   ISR stats reset                    (CFG_ISR_STATS)
+//
+// Compiles to no-ops when CFG_DEBUG_SERIAL == 0.
+// =============================================================================
+
+void telemetry_init(void);
+
+// Call from loop(); drains pending command bytes and answers them.
+void telemetry_poll(uint32_t now_ms);
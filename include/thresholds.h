@@ -9,6 +9,11 @@
 //
 // IMPORTANT: These are raw ADC counts (0..1023). If you change divider or Vref,
 // you MUST re-derive these numbers.
+//
+// The gauge compares against the 12-bit oversampled reading (hw_adc, 0..4092):
+// ADC_OS(x) scales a 10-bit count. Finer cut-points can be written as
+// ADC_OS(x) + k, k in 0..3 quarter-counts.
+#define ADC_OS(c)            ((uint16_t)((c) * 4u))
 
 // -----------------------------------------------------------------------------
 // Battery gauge thresholds (raw ADC counts)
@@ -21,3 +26,43 @@
 // Lockout thresholds (with hysteresis)
 #define ADC_LOCKOUT_ENTER    455
 #define ADC_LOCKOUT_EXIT     475   // hysteresis
+
+// Lockout fast path (hw_adc trip): filtered conversions at or below the trip
+// level in a row before EV_BAT_LOCKOUT_ENTER is raised from the ISR (~1.02 ms
+// each, ~80 ms with the filter lag). SD-write and PhotoMOS inrush sags are
+// shorter than that; exit stays with the polled, hysteretic gauge.
+#define ADC_TRIP_CONVERSIONS 64
+
+// Trip level sits this far below ADC_LOCKOUT_ENTER (loaded): a long, shallow
+// write sag near the threshold is left to the polled gauge, the fast path
+// only catches a rail that is actually collapsing.
+#define ADC_TRIP_MARGIN_MV   100
+
+// -----------------------------------------------------------------------------
+// Load-aware estimate (drv_fuel_gauge)
+// -----------------------------------------------------------------------------
+// Thresholds above are open-circuit (rested pack) counts. Under load the
+// terminal reads I * R_int low, so the gauge adds the sag of the current load
+// class back before comparing:  est = adc + ADC_OS_MV(BAT_SAG_MV(I_load)).
+// Bench estimates; measure R_int as (V_rest - V_rec) / I_rec on the real
+// pack + harness and re-derive.
+#define BAT_R_INT_MOHM       250   // 2S pack + connector + harness
+#define BAT_I_REST_MA         25   // controller only, DVR unpowered
+#define BAT_I_DVR_IDLE_MA    350   // DVR powered, not writing
+#define BAT_I_DVR_REC_MA     600   // DVR recording (sensor + encoder + SD writes)
+
+#define BAT_SAG_MV(i_ma)     ((uint32_t)(i_ma) * BAT_R_INT_MOHM / 1000u)
+
+// Battery-side millivolts -> 12-bit oversampled counts
+// (x 33/101 divider, x 4092/5000 per mV at the pin; 0.267 counts/mV).
+#define ADC_OS_MV(mv)        ((uint16_t)(((uint32_t)(mv) * 135036UL + 252500UL) / 505000UL))
+
+// -----------------------------------------------------------------------------
+// Recording time left (bat_runtime)
+// -----------------------------------------------------------------------------
+// Minutes to lockout at the recording current above (BAT_I_DVR_REC_MA).
+// EV_BAT_RUNTIME_LOW fires once when the estimate drops to the warn level and
+// re-arms only above the re-arm level (a fresh pack, or a rest recovery).
+#define BAT_CAPACITY_MAH         1300   // pack nameplate
+#define BAT_REC_WARN_MIN           10
+#define BAT_REC_WARN_REARM_MIN     13
@@ -28,6 +28,24 @@
 #define T_BOOT_TIMEOUT_MS          8000    // Time allowed for DVR to reach stable LED signature
 #define T_ERROR_AUTOOFF_MS         2500    // Time we signal error before cutting power / returning OFF
 
+// Gesture confirmation (dvr_confirm): time from queueing a DVR press to the
+// expected LED pattern being reported. No LED change at all by then => re-press.
+#define T_CONFIRM_REC_START_MS     5000    // short press + two slow periods + bridge
+#define T_CONFIRM_REC_STOP_MS      5000    // short press + slow blink-end (~2.6 s)
+#define T_CONFIRM_POWER_ON_MS      7000    // long press + LED on; < T_BOOT_TIMEOUT_MS
+#define T_CONFIRM_POWER_OFF_MS     8000    // long press + shutdown burst + OFF quiet time
+
+// Reconciliation (dvr_reconcile): LED must stand this long before the FSM's
+// belief is corrected to it; an unplanned drop that comes back ON within the
+// reboot window gets recording restored.
+#define T_RECONCILE_SETTLE_MS      3000    // also lets DVR auto-record show up first
+#define T_RECONCILE_REBOOT_MS     30000    // longer than this down => a real power-off
+
+// Battery load model (drv_fuel_gauge): after a load-class change the pack
+// relaxes, and the LED-derived recording flag lags the real load by a blink
+// or two, so bucket changes wait this long. Lockout is not held back.
+#define T_BAT_LOAD_SETTLE_MS       2500
+
 // -----------------------------------------------------------------------------
 // DVR shutter emulation timing (executor waveform)  [OUTPUT SIDE]
 // -----------------------------------------------------------------------------
@@ -38,6 +56,10 @@
 #define T_DVR_AFTER_PWROFF_MS       2500
 #define T_DVR_BOOT_PRESS_MS         3000 
 
+// RunCam UART link (rcdp): a 5-byte reply takes ~0.45 ms on the wire at 115200
+#define T_RCDP_RESP_MS               40    // GET_DEVICE_INFO reply deadline
+#define T_RCDP_PROBE_MS            1000    // keepalive / re-discovery period
+
 // -----------------------------------------------------------------------------
 // DVR LED timing classifier thresholds  [INPUT SIDE]
 // -----------------------------------------------------------------------------
@@ -62,11 +84,46 @@
 #define T_FAST_EDGE_MIN_MS         40
 #define T_FAST_EDGE_MAX_MS        180
 
+// Single-period SLOW commit (record-start confirmation fast path)
+// One full ON+OFF pair may commit SLOW_BLINK immediately when it sits inside
+// this tighter envelope AND we pressed record-toggle recently. Anything
+// looser falls back to the 2-period rule above.
+#define T_SLOW_FAST_MIN_MS       1800
+#define T_SLOW_FAST_MAX_MS       2300
+#define T_SLOW_FAST_EDGE_MIN_MS   700
+#define T_SLOW_FAST_EDGE_MAX_MS  1300
+#define T_LED_PRESS_PRIOR_MS     8000    // press -> first full blink pair must land within this
+
+// Predictive blink end: a blink is over once no edge arrives within
+// (last matched period * 5/4 + slack) of the last edge. Capped by the legacy
+// T_SOLID_MS + T_SLOW_MAX_MS quiet window. Slow ~2.6 s, fast ~350 ms.
+#define T_BLINK_END_SLACK_MS      100
+
+// SD-card error vs shutdown burst (drv_dvr_status)
+// A shutdown shows a bounded FAST burst that ends in OFF; a missing/failed
+// card keeps blinking. FAST is a card error as soon as it outlives either
+// bound (measured from the FAST commit), whoever started the shutdown (our
+// press, the DVR's button, its low-voltage cutoff). Window includes the
+// ~350 ms blink-end tail, so at 5 Hz a burst up to ~1.9 s in total passes
+// as a shutdown.
+#define T_CARD_ERR_BURST_MAX_MS  2000    // longest shutdown burst after FAST commits
+#define T_CARD_ERR_BURST_EDGES     20    // most LED edges in that burst (~10 flashes)
+
+// DVR LED -> event bridge (drv_dvr_led), measured on the classifier's change
+// time, not on poll count.
+#define T_LED_BRIDGE_HOLD_MS       30    // pattern must stand this long before it is reported
+#define T_LED_BRIDGE_GAP_MS        30    // minimum spacing between reported changes
+
 // -----------------------------------------------------------------------------
-// Abnormal boot signature (reserved / documented behaviour)
+// Abnormal boot signature (dvr_led signature table)
+// A short slow-blink burst from a non-blinking LED that settles OFF.
 // -----------------------------------------------------------------------------
 #define T_ABN_SLOW_MIN_MS        1200
 #define T_ABN_SLOW_MAX_MS        3200
+#define T_ABN_ON_MIN_MS           300
+#define T_ABN_ON_MAX_MS          1600
 #define T_ABN_OFF_MIN_MS          800
+#define T_ABN_OFF_MAX_MS         2400
+#define T_ABN_BURST_PERIODS         2   // ~T_ABN_BLINK_BURST_MS worth of full ON+OFF pairs
 #define T_ABN_BLINK_BURST_MS     2000   // manual: slow blink for ~2 seconds
 #define T_ABN_SHUTOFF_MS         5000   // manual: shuts off after ~5 seconds
@@ -32,4 +32,5 @@ void ui_policy_on_state_enter(uint32_t now_ms,
 // Momentary feedback hooks
 void ui_policy_on_record_confirmed(uint32_t now_ms);
 void ui_policy_on_stop_confirmed(uint32_t now_ms);
+void ui_policy_on_runtime_low(uint32_t now_ms, uint16_t minutes_left);
 void ui_policy_on_error(uint32_t now_ms, error_code_t err);
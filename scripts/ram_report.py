@@ -0,0 +1,96 @@
+# ram_report.py
+#
+# PlatformIO post-build step: static SRAM per module, drawn from the linker
+# map file (.data + .bss + .noinit input sections, summed per object file).
+#
+# Wired in platformio.ini:
+#   build_flags   = -Wl,-Map,${BUILD_DIR}/firmware.map
+#   extra_scripts = post:scripts/ram_report.py
+#
+# Use together with the runtime stack high-watermark (telemetry 'm') to size
+# CFG_EVENT_QUEUE_SIZE / CFG_ACTION_QUEUE_SIZE and friends from data:
+#   free for stack = RAM size - static total (this report)
+#   stack needed   = stack_peak (telemetry)
+
+import os
+import re
+
+Import("env")  # noqa: F821  (provided by PlatformIO/SCons)
+
+RAM_SECTIONS = (".data", ".bss", ".noinit")
+
+# " .bss.s_buf   0x00800123   0x80 path/to/event_queue.cpp.o"
+# long names wrap: the section name alone, then addr/size/file on next line
+_SEC_RE  = re.compile(r"^ (\.(?:data|bss|noinit)(?:\.\S+)?)(?:\s+(0x[0-9a-f]+)\s+(0x[0-9a-f]+)\s+(\S.*))?$")
+_CONT_RE = re.compile(r"^\s+(0x[0-9a-f]+)\s+(0x[0-9a-f]+)\s+(\S.*)$")
+
+
+def _module_name(path):
+    # "libFrameworkArduino.a(HardwareSerial0.cpp.o)" -> "HardwareSerial0.cpp"
+    m = re.search(r"\(([^)]+)\)$", path)
+    base = m.group(1) if m else os.path.basename(path)
+    return base[:-2] if base.endswith(".o") else base
+
+
+def parse_map(path):
+    per_module = {}
+    pending = None
+
+    with open(path, "r", errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+
+            if pending is not None:
+                m = _CONT_RE.match(line)
+                if m:
+                    _account(per_module, pending, m.group(1), m.group(2), m.group(3))
+                pending = None
+                continue
+
+            m = _SEC_RE.match(line)
+            if not m:
+                continue
+
+            if m.group(2) is None:
+                pending = m.group(1)
+                continue
+
+            _account(per_module, m.group(1), m.group(2), m.group(3), m.group(4))
+
+    return per_module
+
+
+def _account(per_module, section, addr, size, obj):
+    size = int(size, 16)
+    if size == 0:
+        return
+    # Only RAM-resident input sections (AVR data space is mapped at 0x800000)
+    if int(addr, 16) < 0x800000:
+        return
+    kind = next(k for k in RAM_SECTIONS if section.startswith(k))
+    row = per_module.setdefault(_module_name(obj), {k: 0 for k in RAM_SECTIONS})
+    row[kind] += size
+
+
+def ram_report(source, target, env):
+    map_path = os.path.join(env.subst("$BUILD_DIR"), "firmware.map")
+    if not os.path.isfile(map_path):
+        print("RAM report: %s not found (is -Wl,-Map set?)" % map_path)
+        return
+
+    per_module = parse_map(map_path)
+    rows = sorted(per_module.items(), key=lambda kv: -sum(kv[1].values()))
+
+    total = 0
+    print("")
+    print("RAM report (static SRAM per module, bytes)")
+    print("%-32s %6s %6s %7s %6s" % ("module", ".data", ".bss", ".noinit", "total"))
+    for name, row in rows:
+        t = sum(row.values())
+        total += t
+        print("%-32s %6d %6d %7d %6d" % (name, row[".data"], row[".bss"], row[".noinit"], t))
+    print("%-32s %6s %6s %7s %6d" % ("TOTAL", "", "", "", total))
+    print("")
+
+
+env.AddPostAction("$BUILD_DIR/${PROGNAME}.elf", ram_report)  # noqa: F821
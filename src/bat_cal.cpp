@@ -0,0 +1,71 @@
+// bat_cal.cpp
+//
+// Battery ADC calibration record in EEPROM (see bat_cal.h).
+
+#include "bat_cal.h"
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "crc8.h"
+#include "led_cal.h"
+
+#ifdef __AVR__
+  #include <avr/eeprom.h>
+#endif
+
+// Bump when the layout or scale changes: old records then load as identity.
+static const uint8_t BAT_CAL_VERSION = 1;
+
+typedef struct
+{
+    uint8_t   version;
+    bat_cal_t cal;
+    uint8_t   crc;
+} __attribute__((packed)) bat_cal_rec_t;
+
+static_assert(sizeof(bat_cal_rec_t) == BAT_CAL_RECORD_LEN, "EEPROM layout");
+static_assert(CFG_EE_BAT_CAL_ADDR >= CFG_EE_LED_CAL_ADDR + LED_CAL_RECORD_LEN, "overlaps led_cal");
+
+static inline uint8_t rec_crc(const bat_cal_rec_t* r)
+{
+    return crc8_dvb_s2(r, (uint8_t)(sizeof(*r) - 1u));
+}
+
+bool bat_cal_plausible(const bat_cal_t* cal)
+{
+    return cal->gain_q14 >= BAT_CAL_GAIN_MIN && cal->gain_q14 <= BAT_CAL_GAIN_MAX &&
+           cal->offset >= -BAT_CAL_OFFSET_MAX && cal->offset <= BAT_CAL_OFFSET_MAX;
+}
+
+bool bat_cal_load(bat_cal_t* out)
+{
+    bat_cal_rec_t r;
+    eeprom_read_block(&r, (const void*)CFG_EE_BAT_CAL_ADDR, sizeof(r));
+
+    const bat_cal_t c = r.cal;
+    if (r.version != BAT_CAL_VERSION || r.crc != rec_crc(&r) || !bat_cal_plausible(&c))
+    {
+        out->gain_q14 = BAT_CAL_GAIN_ONE;
+        out->offset   = 0;
+        return false;
+    }
+
+    *out = c;
+    return true;
+}
+
+void bat_cal_save(const bat_cal_t* cal)
+{
+    bat_cal_rec_t r;
+    r.version = BAT_CAL_VERSION;
+    r.cal     = *cal;
+    r.crc     = rec_crc(&r);
+
+    eeprom_update_block(&r, (void*)CFG_EE_BAT_CAL_ADDR, sizeof(r));
+}
+
+void bat_cal_erase(void)
+{
+    eeprom_update_byte((uint8_t*)CFG_EE_BAT_CAL_ADDR, 0xFFu);   // blank version
+}
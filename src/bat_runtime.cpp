@@ -0,0 +1,137 @@
+// bat_runtime.cpp
+//
+// State of charge and recording time left (see bat_runtime.h). Main-loop
+// context only; integer arithmetic throughout.
+
+#include "bat_runtime.h"
+
+#include <Arduino.h>
+
+#include "thresholds.h"
+
+#ifdef __AVR__
+  #include <avr/pgmspace.h>
+#endif
+
+// -----------------------------------------------------------------------------
+// 2S LiPo open-circuit discharge curve (rested pack, ~25 C)
+// Descending voltage; SoC interpolated linearly between rows.
+// -----------------------------------------------------------------------------
+typedef struct
+{
+    uint16_t adc;   // ADC_OS_MV(pack mV)
+    uint8_t  pct;   // state of charge, %
+} bat_pt_t;
+
+static const bat_pt_t k_curve[] PROGMEM =
+{
+    { ADC_OS_MV(8400), 100 },
+    { ADC_OS_MV(8300),  95 },
+    { ADC_OS_MV(8220),  90 },
+    { ADC_OS_MV(8160),  85 },
+    { ADC_OS_MV(8040),  80 },
+    { ADC_OS_MV(7960),  75 },
+    { ADC_OS_MV(7900),  70 },
+    { ADC_OS_MV(7820),  65 },
+    { ADC_OS_MV(7740),  60 },
+    { ADC_OS_MV(7700),  55 },
+    { ADC_OS_MV(7680),  50 },
+    { ADC_OS_MV(7640),  45 },
+    { ADC_OS_MV(7600),  40 },
+    { ADC_OS_MV(7580),  35 },
+    { ADC_OS_MV(7540),  30 },
+    { ADC_OS_MV(7500),  25 },
+    { ADC_OS_MV(7460),  20 },
+    { ADC_OS_MV(7420),  15 },
+    { ADC_OS_MV(7380),  10 },
+    { ADC_OS_MV(7220),   5 },
+    { ADC_OS_MV(6540),   0 },
+};
+
+static const uint8_t CURVE_N = (uint8_t)(sizeof(k_curve) / sizeof(k_curve[0]));
+
+static const uint8_t EMA_SHIFT = 3;   // 1/8 per 200 ms sample => ~1.6 s
+static const uint8_t FILT_Q    = 4;   // filtered value kept x16
+
+// -----------------------------------------------------------------------------
+// Internal state
+// -----------------------------------------------------------------------------
+static bool     s_valid     = false;
+static uint16_t s_filt_q    = 0;     // est << FILT_Q, filtered (2246 x 16 fits)
+static uint16_t s_soc_pm    = 0;
+static uint16_t s_lock_pm   = 0;     // SoC at the lockout threshold
+static uint16_t s_minutes   = 0;
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+static uint16_t curve_permille(uint16_t adc)
+{
+    bat_pt_t hi, lo;
+    memcpy_P(&hi, &k_curve[0], sizeof(hi));
+    if (adc >= hi.adc)
+        return (uint16_t)(hi.pct * 10u);
+
+    for (uint8_t i = 1; i < CURVE_N; i++)
+    {
+        memcpy_P(&lo, &k_curve[i], sizeof(lo));
+        if (adc >= lo.adc)
+        {
+            const uint16_t span = (uint16_t)(hi.adc - lo.adc);
+            const uint16_t d_pm = (uint16_t)((hi.pct - lo.pct) * 10u);
+            const uint32_t num  = (uint32_t)(adc - lo.adc) * d_pm + (span >> 1);
+            return (uint16_t)(lo.pct * 10u + num / span);
+        }
+        hi = lo;
+    }
+    return 0;
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+void bat_runtime_init(void)
+{
+    s_valid   = false;
+    s_filt_q  = 0;
+    s_soc_pm  = 0;
+    s_minutes = 0;
+    s_lock_pm = curve_permille(ADC_OS(ADC_LOCKOUT_ENTER));
+}
+
+void bat_runtime_update(uint16_t est_adc)
+{
+    const uint16_t x_q = (uint16_t)(est_adc << FILT_Q);
+
+    if (!s_valid)
+    {
+        s_filt_q = x_q;
+        s_valid  = true;
+    }
+    else
+    {
+        s_filt_q = (uint16_t)(s_filt_q + (((int32_t)x_q - (int32_t)s_filt_q) >> EMA_SHIFT));
+    }
+
+    s_soc_pm = curve_permille((uint16_t)((s_filt_q + (1u << (FILT_Q - 1))) >> FILT_Q));
+
+    // permille x mAh x 60 / (1000 x mA): <= 1000 x 65535 x 60 needs 32 bits
+    const uint16_t usable_pm = (s_soc_pm > s_lock_pm) ? (uint16_t)(s_soc_pm - s_lock_pm) : 0;
+    s_minutes = (uint16_t)(((uint32_t)usable_pm * BAT_CAPACITY_MAH * 60u)
+                           / (1000UL * BAT_I_DVR_REC_MA));
+}
+
+bool bat_runtime_valid(void)
+{
+    return s_valid;
+}
+
+uint16_t bat_runtime_soc_permille(void)
+{
+    return s_soc_pm;
+}
+
+uint16_t bat_runtime_rec_minutes(void)
+{
+    return s_minutes;
+}
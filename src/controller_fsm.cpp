@@ -14,6 +14,10 @@
 //   - Boot completion is LED-confirmed (EV_DVR_POWERED_ON_IDLE), not timer-assumed.
 //   - Recording start/stop confirmations are LED-confirmed (EV_DVR_RECORD_*).
 //   - SD-card missing / persistent FAST blink becomes EV_DVR_ERROR(ERR_DVR_CARD_ERROR) -> STATE_ERROR.
+//   - Every DVR gesture is tracked by dvr_confirm; a press the DVR never reacted
+//     to is re-issued (bounded), and a power-on retry restarts the boot window.
+//   - dvr_reconcile keeps the FSM's belief in line with the settled LED (DVR
+//     rebooted, physical button used) and restores recording after a reboot.
 //
 // Notes:
 // - No new timing constants: uses T_BOOT_TIMEOUT_MS only.
@@ -29,6 +33,9 @@
 #include "action_queue.h"
 #include "timings.h"
 #include "ui_policy.h"
+#include "dvr_confirm.h"
+#include "dvr_reconcile.h"
+#include "drv_fuel_gauge.h"
 
 // -----------------------------------------------------------------------------
 // Internal state
@@ -64,8 +71,33 @@ static inline void emit_action(uint32_t now_ms, action_id_t id, uint16_t arg0, u
     (void)actionq_push(&a);
 }
 
-static inline void act_dvr_short(uint32_t now_ms) { emit_action(now_ms, ACT_DVR_PRESS_SHORT, 0, 0); }
-static inline void act_dvr_long (uint32_t now_ms) { emit_action(now_ms, ACT_DVR_PRESS_LONG,  0, 0); }
+// arg0 = dvr_gesture_t, so the executor can route record toggles (UART backend)
+static inline void act_dvr_short(uint32_t now_ms, dvr_gesture_t g) { emit_action(now_ms, ACT_DVR_PRESS_SHORT, (uint16_t)g, 0); }
+static inline void act_dvr_long (uint32_t now_ms, dvr_gesture_t g) { emit_action(now_ms, ACT_DVR_PRESS_LONG,  (uint16_t)g, 0); }
+
+static inline void act_dvr_press(uint32_t now_ms, dvr_gesture_t g)
+{
+    if (dvr_confirm_is_long(g)) act_dvr_long(now_ms, g);
+    else                        act_dvr_short(now_ms, g);
+}
+
+// Issue a DVR gesture and track its expected LED outcome
+static inline void act_dvr_gesture(uint32_t now_ms, dvr_gesture_t g)
+{
+    act_dvr_press(now_ms, g);
+    dvr_confirm_start(now_ms, g);
+    dvr_reconcile_note_gesture(g);
+}
+
+static inline controller_state_t state_from_view(dvr_view_t v)
+{
+    switch (v)
+    {
+        case DVR_VIEW_IDLE:      return STATE_IDLE;
+        case DVR_VIEW_RECORDING: return STATE_RECORDING;
+        default:                 return STATE_OFF;
+    }
+}
 
 // -----------------------------------------------------------------------------
 // State + error transitions (UI policy on entry)
@@ -76,6 +108,7 @@ static inline void set_state(uint32_t now_ms, controller_state_t next)
         return;
 
     s_state = next;
+    drv_fuel_gauge_set_fsm_state(s_state);
     ui_policy_on_state_enter(now_ms, s_state, s_err, s_bat);
 }
 
@@ -117,6 +150,7 @@ static void handle_battery_event(uint32_t now_ms, const event_t* ev)
         case EV_BAT_LOCKOUT_ENTER:
         {
             s_lockout = true;
+            dvr_confirm_cancel();   // no automatic presses under lockout
             s_err     = ERR_BAT_LOCKOUT;
             set_state(now_ms, STATE_LOCKOUT);
             return;
@@ -132,6 +166,14 @@ static void handle_battery_event(uint32_t now_ms, const event_t* ev)
             return;
         }
 
+        case EV_BAT_RUNTIME_LOW:
+        {
+            // Early cue only; no state change. Silent while the DVR is off.
+            if (s_state == STATE_IDLE || s_state == STATE_RECORDING)
+                ui_policy_on_runtime_low(now_ms, ev->arg0);
+            return;
+        }
+
         default:
             return;
     }
@@ -160,7 +202,7 @@ static void handle_button_event(uint32_t now_ms, const event_t* ev)
                 return;
 
             // Power on request -> long press to DVR
-            act_dvr_long(now_ms);
+            act_dvr_gesture(now_ms, DVR_GEST_POWER_ON);
 
             s_err = ERR_NONE;
             set_state(now_ms, STATE_BOOTING);
@@ -179,7 +221,7 @@ static void handle_button_event(uint32_t now_ms, const event_t* ev)
             if (is_short)
             {
                 // Request start recording; confirmation arrives from EV_DVR_RECORD_STARTED.
-                act_dvr_short(now_ms);
+                act_dvr_gesture(now_ms, DVR_GEST_REC_START);
 
                 // DO NOT transition to RECORDING yet: wait for LED-confirmation event.
                 // Keep UI minimal here; if you want a “click” you can add it in ui_policy later.
@@ -187,7 +229,7 @@ static void handle_button_event(uint32_t now_ms, const event_t* ev)
             else
             {
                 // Grace/long => power off
-                act_dvr_long(now_ms);
+                act_dvr_gesture(now_ms, DVR_GEST_POWER_OFF);
                 clear_error_if(now_ms, STATE_OFF);
                 set_state(now_ms, STATE_OFF);
             }
@@ -199,12 +241,12 @@ static void handle_button_event(uint32_t now_ms, const event_t* ev)
             if (is_short)
             {
                 // Request stop recording; confirmation arrives from EV_DVR_RECORD_STOPPED.
-                act_dvr_short(now_ms);
+                act_dvr_gesture(now_ms, DVR_GEST_REC_STOP);
             }
             else
             {
                 // Grace/long => power off
-                act_dvr_long(now_ms);
+                act_dvr_gesture(now_ms, DVR_GEST_POWER_OFF);
                 clear_error_if(now_ms, STATE_OFF);
                 set_state(now_ms, STATE_OFF);
             }
@@ -216,7 +258,7 @@ static void handle_button_event(uint32_t now_ms, const event_t* ev)
             // Minimal: allow OFF via long; ignore short (prevents starting recording in low bat)
             if (is_long)
             {
-                act_dvr_long(now_ms);
+                act_dvr_gesture(now_ms, DVR_GEST_POWER_OFF);
                 clear_error_if(now_ms, STATE_OFF);
                 set_state(now_ms, STATE_OFF);
             }
@@ -228,7 +270,7 @@ static void handle_button_event(uint32_t now_ms, const event_t* ev)
             // In ERROR, allow user to power-off via long (escape hatch).
             if (is_long)
             {
-                act_dvr_long(now_ms);
+                act_dvr_gesture(now_ms, DVR_GEST_POWER_OFF);
                 // remain in error until DVR actually powers off (EV_DVR_POWERED_OFF),
                 // or just drop to OFF immediately (choose one). We'll drop immediately:
                 set_state(now_ms, STATE_OFF);
@@ -318,17 +360,30 @@ static void handle_dvr_semantic_event(uint32_t now_ms, const event_t* ev)
 void controller_fsm_init(void)
 {
     s_state = STATE_OFF;
+    drv_fuel_gauge_set_fsm_state(s_state);
     s_bat   = BAT_UNKNOWN;
     s_lockout = false;
     s_err   = ERR_NONE;
     s_boot_deadline_ms = 0;
 
+    dvr_confirm_init();
+    dvr_reconcile_init();
     ui_policy_init();
     ui_policy_on_state_enter(0, s_state, s_err, s_bat);
 }
 
 void controller_fsm_poll(uint32_t now_ms)
 {
+    // Gesture confirmation: re-press what the DVR never reacted to. Runs
+    // before the boot timeout so a power-on retry gets a fresh boot window.
+    const dvr_gesture_t retry = dvr_confirm_poll(now_ms);
+    if (retry != DVR_GEST_NONE && !s_lockout)
+    {
+        act_dvr_press(now_ms, retry);
+        if (retry == DVR_GEST_POWER_ON && s_state == STATE_BOOTING)
+            s_boot_deadline_ms = now_ms + (uint32_t)T_BOOT_TIMEOUT_MS;
+    }
+
     // Boot timeout fallback:
     // - If we don't receive EV_DVR_POWERED_ON_IDLE by deadline, treat as boot timeout error.
     if (s_state == STATE_BOOTING && time_reached(now_ms, s_boot_deadline_ms))
@@ -343,7 +398,8 @@ void controller_fsm_poll(uint32_t now_ms)
         // Battery first (dominant)
         if (ev.id == EV_BAT_STATE_CHANGED ||
             ev.id == EV_BAT_LOCKOUT_ENTER ||
-            ev.id == EV_BAT_LOCKOUT_EXIT)
+            ev.id == EV_BAT_LOCKOUT_EXIT  ||
+            ev.id == EV_BAT_RUNTIME_LOW)
         {
             handle_battery_event(now_ms, &ev);
             continue;
@@ -369,6 +425,17 @@ void controller_fsm_poll(uint32_t now_ms)
 
         // Ignore other events for now
     }
+
+    // Reconcile belief with the settled LED once events are applied
+    dvr_reconcile_fix_t fix;
+    if (!s_lockout && dvr_reconcile_poll(now_ms, s_state, &fix))
+    {
+        if (fix.adopt != DVR_VIEW_UNKNOWN)
+            set_state(now_ms, state_from_view(fix.adopt));
+
+        if (fix.gesture != DVR_GEST_NONE)
+            act_dvr_gesture(now_ms, fix.gesture);
+    }
 }
 
 controller_state_t controller_fsm_state(void)
@@ -6,8 +6,15 @@
 //
 // Notes:
 // - dvr_led.cpp already has hysteresis for blink detection.
-// - This bridge adds a small stability filter to reduce chatter
-//   between UNKNOWN/SOLID/OFF at start-up or when wiring is noisy.
+// - Changes are only considered once dvr_led_get_confidence() reaches
+//   CFG_DVR_LED_EMIT_MIN_CONF (decaying per-pattern score).
+// - Stability filter is time-based on the classifier's own change time
+//   (dvr_led_get_pattern_since), so confirmation latency does not depend on
+//   how fast loop() runs:
+//     hold-off : the pattern must have stood T_LED_BRIDGE_HOLD_MS
+//     spacing  : reports at least T_LED_BRIDGE_GAP_MS apart (signal time;
+//                a change decided inside the gap is stamped at its end)
+// - Event t_ms is the classifier change time (millis domain), not poll time.
 // - No buffering: emits only on accepted changes.
 //
 
@@ -18,22 +25,21 @@
 #include "dvr_led.h"
 #include "event_queue.h"
 #include "enums.h"
-
-// -----------------------------------------------------------------------------
-// Module-local hygiene only (NOT global timing constants)
-// -----------------------------------------------------------------------------
-static const uint16_t kMinEmitSpacingMs = 30;   // rate-limit rapid churn
-static const uint8_t  kStableReq        = 2;    // consecutive polls to accept change
+#include "config.h"
+#include "timings.h"
+#include "hw_timer.h"
 
 // -----------------------------------------------------------------------------
 // Internal state
 // -----------------------------------------------------------------------------
 static dvr_led_pattern_t s_reported       = DVR_LED_UNKNOWN;
-static dvr_led_pattern_t s_candidate      = DVR_LED_UNKNOWN;
-static uint8_t           s_candidate_cnt  = 0;
+static uint32_t          s_last_change_ms = 0;   // classifier time of last report
 
-static uint32_t          s_last_emit_ms   = 0;
-static uint32_t          s_last_change_ms = 0;
+// Pending (not yet reported) change: its Timer1 stamp, converted to millis
+// once on first sight so a change held back for a long time keeps its age
+static bool              s_pend_valid     = false;
+static uint32_t          s_pend_tk        = 0;
+static uint32_t          s_pend_ms        = 0;
 
 // -----------------------------------------------------------------------------
 // Local helpers
@@ -43,6 +49,13 @@ static inline bool time_reached(uint32_t now, uint32_t deadline)
     return (int32_t)(now - deadline) >= 0;
 }
 
+// Age of a Timer1 timestamp in ms (main context). Only valid for ages below
+// the 35.8 min wrap of the 32-bit Timer1 count: call it on fresh stamps only.
+static inline uint32_t tk_age_ms(uint32_t since_tk)
+{
+    return (hw_timer_now32() - since_tk) / HW_TIMER_TICKS_PER_MS;
+}
+
 // If your event_t includes optional metadata fields, define these in config.h
 // (or build flags) to enable population.
 //   CFG_EVENT_HAS_SRC=1    -> event_t has .src
@@ -54,10 +67,10 @@ static inline bool time_reached(uint32_t now, uint32_t deadline)
 #define CFG_EVENT_HAS_REASON 0
 #endif
 
-static inline void emit_led_event(uint32_t now_ms, dvr_led_pattern_t pat)
+static inline void emit_led_event(uint32_t at_ms, dvr_led_pattern_t pat)
 {
     event_t e;
-    e.t_ms   = now_ms;
+    e.t_ms   = at_ms;
     e.id     = EV_DVR_LED_PATTERN_CHANGED;
     e.src    = SRC_DVR_LED;
     e.reason = EVR_CLASSIFIER_STABLE;
@@ -76,11 +89,8 @@ void drv_dvr_led_init(void)
     dvr_led_init();
 
     s_reported       = DVR_LED_UNKNOWN;
-    s_candidate      = DVR_LED_UNKNOWN;
-    s_candidate_cnt  = 0;
-
-    s_last_emit_ms   = 0;
     s_last_change_ms = 0;
+    s_pend_valid     = false;
 }
 
 void drv_dvr_led_poll(uint32_t now_ms)
@@ -88,35 +98,45 @@ void drv_dvr_led_poll(uint32_t now_ms)
     // Keep classifier alive
     dvr_led_poll(now_ms);
 
-    const dvr_led_pattern_t p = dvr_led_get_pattern();
+    uint32_t since_tk;
+    const dvr_led_pattern_t p = dvr_led_get_pattern_since(&since_tk);
 
-    // Candidate stability filter
-    if (p != s_candidate)
+    if (p == s_reported)
     {
-        s_candidate     = p;
-        s_candidate_cnt = 1;
+        s_pend_valid = false;
         return;
     }
 
-    if (s_candidate_cnt < 255)
-        s_candidate_cnt++;
+    // First poll to see this change: the stamp is at most one loop old here,
+    // well inside the Timer1 wrap; from now on age runs on millis()
+    if (!s_pend_valid || since_tk != s_pend_tk)
+    {
+        s_pend_valid = true;
+        s_pend_tk    = since_tk;
+        s_pend_ms    = now_ms - tk_age_ms(since_tk);
+    }
 
-    if (s_candidate_cnt < kStableReq)
+    // Classifier not sure enough yet: hold the current report
+    if (dvr_led_get_confidence() < CFG_DVR_LED_EMIT_MIN_CONF)
         return;
 
-    // Candidate is stable enough. Only emit if it differs from reported.
-    if (s_candidate == s_reported)
+    // Hold-off on signal time: the pattern must have stood long enough
+    if (!time_reached(now_ms, s_pend_ms + T_LED_BRIDGE_HOLD_MS))
         return;
 
-    // Rate-limit chatter
-    if (!time_reached(now_ms, s_last_emit_ms + kMinEmitSpacingMs))
+    // Spacing on signal time: a change decided too soon after the last
+    // report is stamped GAP after it, and waits until then
+    uint32_t at_ms = s_pend_ms;
+    if (!time_reached(at_ms, s_last_change_ms + T_LED_BRIDGE_GAP_MS))
+        at_ms = s_last_change_ms + T_LED_BRIDGE_GAP_MS;
+    if (!time_reached(now_ms, at_ms))
         return;
 
-    s_reported       = s_candidate;
-    s_last_emit_ms   = now_ms;
-    s_last_change_ms = now_ms;
+    s_reported       = p;
+    s_last_change_ms = at_ms;
+    s_pend_valid     = false;
 
-    emit_led_event(now_ms, s_reported);
+    emit_led_event(at_ms, p);
 }
 
 dvr_led_pattern_t drv_dvr_led_last_pattern(void)
@@ -128,3 +148,13 @@ uint32_t drv_dvr_led_last_change_ms(void)
 {
     return s_last_change_ms;
 }
+
+bool drv_dvr_led_fast_burst(uint32_t now_ms, uint8_t* edges, uint32_t* age_ms)
+{
+    if (s_reported != DVR_LED_FAST_BLINK || dvr_led_get_pattern() != DVR_LED_FAST_BLINK)
+        return false;
+
+    *edges  = dvr_led_blink_edges();
+    *age_ms = now_ms - s_last_change_ms;
+    return true;
+}
@@ -13,10 +13,16 @@
 //   - EV_DVR_ERROR  (arg0 = error_code_t, arg1 = last dvr_led_pattern_t)
 //
 // Notes:
-//   - Purely LED-driven, no new timing constants. Uses T_BOOT_TIMEOUT_MS.
-//   - High-value discriminator:
-//       FAST_BLINK persisting beyond window => ERR_DVR_CARD_ERROR
-//     (RunCam "missing microSD" tends to be persistent fast blink.)
+//   - Purely LED-driven.
+//   - High-value discriminator (RunCam "missing microSD" is persistent fast
+//     blink; a shutdown is a bounded FAST burst that ends in OFF):
+//       FAST_BLINK > T_CARD_ERR_BURST_EDGES edges, or
+//       > T_CARD_ERR_BURST_MAX_MS after commit           => ERR_DVR_CARD_ERROR
+//     The same bounds apply whoever started the shutdown: our power-off
+//     press, the DVR's own power button or its low-voltage cutoff all give
+//     the same burst, so no FSM state is consulted.
+//   - ABNORMAL_BOOT (classifier signature: short slow burst then OFF)
+//       => ERR_DVR_ABNORMAL_BOOT, immediately.
 //   - Preserves all non-LED events by stashing + re-pushing.
 //   - Deterministic: emits only on pattern changes and one-shot error.
 //
@@ -31,16 +37,16 @@
 #include "enums.h"
 #include "event_queue.h"
 #include "timings.h"
+#include "drv_dvr_led.h"
 
 // -----------------------------------------------------------------------------
 // Internal state
 // -----------------------------------------------------------------------------
 static dvr_led_pattern_t s_last_pat = DVR_LED_UNKNOWN;
 
-// Persistent fast-blink discriminator
-static bool     s_fast_persist_armed = false;
-static uint32_t s_fast_deadline_ms   = 0;
-static bool     s_sd_error_emitted   = false;   // one-shot latch while FAST persists
+// Fast-blink (shutdown burst vs card error) discriminator
+static bool     s_fast_armed       = false;
+static bool     s_sd_error_emitted = false;   // one-shot latch while FAST persists
 
 // Recording latch (derived; not authoritative)
 static bool s_recording = false;
@@ -48,11 +54,6 @@ static bool s_recording = false;
 // -----------------------------------------------------------------------------
 // Helpers
 // -----------------------------------------------------------------------------
-static inline bool time_reached(uint32_t now, uint32_t deadline)
-{
-    return (int32_t)(now - deadline) >= 0;
-}
-
 static inline void emit_event(uint32_t now_ms,
                               event_id_t id,
                               event_reason_t reason,
@@ -71,23 +72,35 @@ static inline void emit_event(uint32_t now_ms,
 
 // Conservative “normalising” patterns that should cancel SD suspicion.
 // (OFF is shutdown complete; SOLID is idle; UNKNOWN is transitional.)
-static inline bool cancels_fast_persist(dvr_led_pattern_t p)
+static inline bool cancels_fast_burst(dvr_led_pattern_t p)
 {
     return (p == DVR_LED_OFF) || (p == DVR_LED_SOLID) || (p == DVR_LED_UNKNOWN);
 }
 
-static void arm_fast_persist(uint32_t now_ms)
+static void arm_fast_burst(void)
 {
-    s_fast_persist_armed = true;
-    s_fast_deadline_ms   = now_ms + (uint32_t)T_BOOT_TIMEOUT_MS;
-    s_sd_error_emitted   = false;   // new fast-blink episode => allow one-shot again
+    s_fast_armed       = true;
+    s_sd_error_emitted = false;   // new fast-blink episode => allow one-shot again
 }
 
-static void disarm_fast_persist(void)
+static void disarm_fast_burst(void)
 {
-    s_fast_persist_armed = false;
-    s_fast_deadline_ms   = 0;
-    s_sd_error_emitted   = false;
+    s_fast_armed       = false;
+    s_sd_error_emitted = false;
+}
+
+// A FAST burst that outlived the shutdown signature. Only judged while the
+// classifier itself still sees FAST (drv_dvr_led_fast_burst), so a burst
+// whose OFF is already decided (but not yet bridged) is never miscounted.
+static bool fast_burst_overrun(uint32_t now_ms)
+{
+    uint8_t  edges;
+    uint32_t age_ms;
+    if (!drv_dvr_led_fast_burst(now_ms, &edges, &age_ms))
+        return false;
+
+    return (edges > (uint8_t)T_CARD_ERR_BURST_EDGES) ||
+           (age_ms >= (uint32_t)T_CARD_ERR_BURST_MAX_MS);
 }
 
 static void on_pattern_changed(uint32_t now_ms, dvr_led_pattern_t pat)
@@ -115,39 +128,50 @@ static void on_pattern_changed(uint32_t now_ms, dvr_led_pattern_t pat)
     {
         emit_event(now_ms, EV_DVR_POWERED_OFF, EVR_CLASSIFIER_STABLE, 0, 0);
         // FAST->OFF is a normal shutdown signature; not an SD error.
-        disarm_fast_persist();
+        disarm_fast_burst();
     }
     else if (pat == DVR_LED_SOLID)
     {
         emit_event(now_ms, EV_DVR_POWERED_ON_IDLE, EVR_CLASSIFIER_STABLE, 0, 0);
         // SOLID implies "normal", so cancel SD suspicion.
-        disarm_fast_persist();
+        disarm_fast_burst();
     }
 
-    // 3) SD card discriminator: FAST_BLINK persistence
+    // 3) SD card discriminator: FAST_BLINK burst bounds
     //
     // Important nuance:
-    // - During shutdown, you may see FAST_BLINK then OFF fairly quickly.
+    // - During shutdown, you see a bounded FAST_BLINK burst, then OFF.
     // - In “missing microSD” error, FAST_BLINK tends to persist indefinitely.
     //
     // Therefore:
-    // - Arm the timer when entering FAST_BLINK.
-    // - Keep it armed while FAST_BLINK continues.
+    // - Arm on entering FAST_BLINK (at the LED change time).
+    // - Judge it in poll: too many edges, or too long => error.
     // - Disarm on OFF/SOLID/UNKNOWN (normalising patterns).
     if (pat == DVR_LED_FAST_BLINK)
     {
-        // If this is a *new* episode, arm it; if already armed, leave deadline alone.
-        if (!s_fast_persist_armed)
-            arm_fast_persist(now_ms);
+        // If this is a *new* episode, arm it; if already armed, leave it alone.
+        if (!s_fast_armed)
+            arm_fast_burst();
     }
-    else if (cancels_fast_persist(pat))
+    else if (cancels_fast_burst(pat))
     {
-        disarm_fast_persist();
+        disarm_fast_burst();
     }
     else
     {
         // For ABNORMAL_BOOT or other non-fast patterns: cancel suspicion.
-        disarm_fast_persist();
+        disarm_fast_burst();
+    }
+
+    // 4) Abnormal boot: the classifier already required the full signature
+    //    (burst + terminal OFF), so report it straight away.
+    if (pat == DVR_LED_ABNORMAL_BOOT)
+    {
+        emit_event(now_ms,
+                   EV_DVR_ERROR,
+                   EVR_CLASSIFIER_STABLE,
+                   (uint16_t)ERR_DVR_ABNORMAL_BOOT,
+                   (uint16_t)pat);
     }
 }
 
@@ -167,8 +191,9 @@ static void poll_led_pattern_events(uint32_t now_ms)
 
             if (pat != s_last_pat)
             {
+                // Stamp derived events with the LED change time, not poll time
                 s_last_pat = pat;
-                on_pattern_changed(now_ms, pat);
+                on_pattern_changed(ev.t_ms, pat);
             }
             continue;
         }
@@ -192,19 +217,23 @@ void drv_dvr_status_init(void)
 
     s_recording = false;
 
-    disarm_fast_persist();
+    disarm_fast_burst();
 }
 
 void drv_dvr_status_poll(uint32_t now_ms)
 {
     poll_led_pattern_events(now_ms);
 
-    // SD card error discriminator: FAST_BLINK that does NOT resolve within window
-    if (s_fast_persist_armed && !s_sd_error_emitted && time_reached(now_ms, s_fast_deadline_ms))
+    // SD card error discriminator: FAST_BLINK that is not a shutdown burst
+    if (s_fast_armed && !s_sd_error_emitted)
     {
+        if (!fast_burst_overrun(now_ms))
+            return;
+
         // Emit a semantic DVR error:
         //   arg0 = error_code_t (ERR_DVR_CARD_ERROR)
         //   arg1 = last LED pattern (audit)
+        //   reason: TIMEOUT = burst overran the shutdown signature
         emit_event(now_ms,
                    EV_DVR_ERROR,
                    EVR_TIMEOUT,
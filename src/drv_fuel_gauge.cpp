@@ -1,15 +1,31 @@
 // drv_fuel_gauge.cpp
 //
 // Driver-level fuel gauge:
-// - Samples ADC (PIN_FUELGAUGE_ADC)
+// - Takes the 12-bit oversampled ADC result (hw_adc: auto-triggered, ISR
+//   accumulated; no blocking analogRead in loop())
+// - Ratio-corrects for AVCC drift against the 1.1 V bandgap (hw_adc), so
+//   readings are what a 5.00 V reference would give (thresholds.h scale)
+// - Applies the per-unit calibration (bat_cal, EEPROM). Its gain is folded
+//   into the ratio scale, rebuilt only when the bandgap moves: per sample it
+//   is one multiply, shift and add whether calibrated or not
+// - Adds the IR drop of the present load class (DVR LED pattern + recording
+//   flag, FSM state until the LED is classified) to get an open-circuit
+//   estimate; thresholds apply to that
 // - Classifies into battery_state_t buckets using thresholds.h
+// - Feeds bat_runtime (SoC, recording minutes to lockout); one
+//   EV_BAT_RUNTIME_LOW when that drops to BAT_REC_WARN_MIN
 // - Applies stability requirement (N consecutive samples) before reporting changes
 // - Applies lockout hysteresis (enter/exit thresholds) with the same stability requirement
+// - Lockout fast path: an hw_adc trip at ADC_LOCKOUT_ENTER raises
+//   EV_BAT_LOCKOUT_ENTER from ADC_vect, at the head of the queue, ~80 ms after
+//   the rail drops ADC_TRIP_MARGIN_MV under it (the polled path needs
+//   >= 600 ms). Load sags shorter than that do not trip. Exit is polled only.
 // - Emits events into event_queue (no policy decisions here)
 //
 // Event contract (consistent across battery events):
 //   arg0 = (uint16_t)battery_state_t  (state at time of event)
-//   arg1 = adc reading (0..1023)
+//   arg1 = open-circuit estimate (12-bit oversampled scale, 0..4092 + sag)
+// except EV_BAT_RUNTIME_LOW: arg0 = minutes left, arg1 = SoC permille
 //
 // Uses existing identifiers from: pins.h, thresholds.h, enums.h, timings.h, event_queue.h
 
@@ -22,6 +38,14 @@
 #include "timings.h"
 #include "enums.h"
 #include "event_queue.h"
+#include "hw_adc.h"
+#include "drv_dvr_status.h"
+#include "bat_runtime.h"
+#include "bat_cal.h"
+
+#ifdef __AVR__
+  #include <util/atomic.h>
+#endif
 
 // -----------------------------------------------------------------------------
 // Sampling/stability configuration
@@ -44,8 +68,38 @@ static const uint8_t kStableSamplesReq = (uint8_t)T_FUEL_STABLE_SAMPLES;
 // -----------------------------------------------------------------------------
 static uint32_t        g_next_sample_ms = 0;
 static uint16_t        g_last_adc       = 0;
+static uint16_t        g_est_adc        = 0;
+static uint16_t        g_bandgap        = HW_ADC_BG_NOMINAL;   // last trusted; nominal = no correction
+static uint16_t        g_last_raw       = 0;                   // as hw_adc gave it
+
+// reading x scale >> 16 + offset; scale = (bg nominal / bandgap) x cal gain
+static bat_cal_t       g_cal            = { BAT_CAL_GAIN_ONE, 0 };
+static uint32_t        g_scale_q16      = 65536UL;
+static uint16_t        g_scale_bg       = 0;    // bandgap g_scale_q16 was built for
+
+// Copy of scale + offset for the trip hook, published with interrupts off
+static volatile uint32_t g_isr_scale_q16 = 65536UL;
+static volatile int16_t  g_isr_offset    = 0;
+
+// First point of a two-point calibration (0 = none this session)
+static uint16_t        g_cal_m1         = 0;
+static uint16_t        g_cal_t1         = 0;
+
+// Load model: IR drop per load class, 12-bit counts
+static const uint16_t  kSagCounts[] =
+{
+    ADC_OS_MV(BAT_SAG_MV(BAT_I_REST_MA)),
+    ADC_OS_MV(BAT_SAG_MV(BAT_I_DVR_IDLE_MA)),
+    ADC_OS_MV(BAT_SAG_MV(BAT_I_DVR_REC_MA))
+};
+
+// g_load / g_reported_state are read by the ADC_vect trip hook: one byte
+// each, so a plain volatile store is atomic
+static volatile bat_load_t g_load       = BAT_LOAD_REST;
+static uint32_t        g_settle_until   = 0;    // buckets held until then
+static controller_state_t g_fsm_state   = STATE_OFF;   // pushed by the controller
 
-static battery_state_t g_reported_state       = BAT_UNKNOWN;
+static volatile battery_state_t g_reported_state = BAT_UNKNOWN;
 static battery_state_t g_candidate_state      = BAT_UNKNOWN;
 static uint8_t         g_candidate_count      = 0;
 
@@ -53,6 +107,10 @@ static bool            g_lockout_active           = false;
 static bool            g_lockout_candidate        = false;
 static uint8_t         g_lockout_candidate_count  = 0;
 
+static bool            g_runtime_warned           = false;
+
+static volatile bool   g_fast_tripped             = false;   // set by the ADC_vect hook
+
 // -----------------------------------------------------------------------------
 // Helpers
 // -----------------------------------------------------------------------------
@@ -72,14 +130,124 @@ static inline void emit_bat_event(uint32_t now_ms,
     (void)eventq_push(&e);
 }
 
+// Ratio correction + calibration in one step (4092 x ~82000 < 2^32)
+static inline uint16_t apply_scale(uint16_t adc, uint32_t scale_q16, int16_t offset)
+{
+    const int32_t v = (int32_t)(((uint32_t)adc * scale_q16 + 0x8000UL) >> 16) + offset;
+    return (v > 0) ? (uint16_t)v : 0;
+}
+
+// ADC_vect context: report the crossing now, let poll() adopt the state later.
+// arg1 is the same estimate the polled path reports, from the filtered value.
+static void on_lockout_trip_isr(uint16_t raw)
+{
+    const uint16_t adc = apply_scale(ADC_OS(raw), g_isr_scale_q16, g_isr_offset);
+
+    event_t e;
+    e.t_ms   = millis();
+    e.id     = EV_BAT_LOCKOUT_ENTER;
+    e.src    = SRC_BATTERY;
+    e.reason = EVR_EDGE_FALL;
+    e.arg0   = (uint16_t)g_reported_state;
+    e.arg1   = (uint16_t)(adc + kSagCounts[g_load]);
+    (void)eventq_push_front_isr(&e);
+
+    g_fast_tripped = true;
+}
+
+// Scale to what a 5.00 V AVCC would have read (bg = bandgap at actual AVCC)
+static inline uint16_t ratio_correct(uint16_t adc, uint16_t bg)
+{
+    return (uint16_t)(((uint32_t)adc * HW_ADC_BG_NOMINAL + (bg >> 1)) / bg);
+}
+
+// 900 x 18842 x 4 < 2^26: fits; result ~65536 +- 25 %
+static void rebuild_scale(void)
+{
+    g_scale_q16 = ((uint32_t)HW_ADC_BG_NOMINAL * g_cal.gain_q14 * 4u + (g_bandgap >> 1)) / g_bandgap;
+    g_scale_bg  = g_bandgap;
+
+#ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#endif
+    {
+        g_isr_scale_q16 = g_scale_q16;
+        g_isr_offset    = g_cal.offset;
+    }
+}
+
+static inline uint16_t calibrate(uint16_t adc)
+{
+    return apply_scale(adc, g_scale_q16, g_cal.offset);
+}
+
+// Trip compares filtered 10-bit conversions at the actual AVCC: lower the
+// level by this load's sag and the trip margin, then undo calibration and
+// ratio correction
+static inline uint16_t trip_level(void)
+{
+    const int32_t level = (int32_t)ADC_OS(ADC_LOCKOUT_ENTER) - (int32_t)kSagCounts[g_load]
+                        - (int32_t)ADC_OS_MV(ADC_TRIP_MARGIN_MV) - g_cal.offset;
+    if (level <= 0)
+        return 0;
+
+    const uint32_t raw12 = (((uint32_t)level << 16) + (g_scale_q16 >> 1)) / g_scale_q16;
+    return (uint16_t)((raw12 + 2u) >> 2);
+}
+
+static inline void arm_lockout_trip(void)
+{
+    hw_adc_trip_arm(trip_level(), ADC_TRIP_CONVERSIONS, on_lockout_trip_isr);
+}
+
+// The DVR hangs on the pack directly: whether it draws is what its LED says,
+// not what the FSM asked for (LOCKOUT with a DVR that missed the power-off
+// press still draws, RECORDING with a crashed DVR does not). FSM state only
+// until the LED is classified.
+static inline bat_load_t current_load(void)
+{
+    switch (drv_dvr_status_last_led_pattern())
+    {
+        case DVR_LED_OFF:
+            return BAT_LOAD_REST;
+        case DVR_LED_UNKNOWN:
+            break;
+        default:                        // SLOW / SOLID / FAST / ABNORMAL_BOOT: powered
+            return drv_dvr_status_recording_assumed() ? BAT_LOAD_DVR_REC : BAT_LOAD_DVR_IDLE;
+    }
+
+    switch (g_fsm_state)
+    {
+        case STATE_RECORDING:
+            return BAT_LOAD_DVR_REC;
+        case STATE_OFF:
+        case STATE_LOCKOUT:
+            return BAT_LOAD_REST;
+        default:
+            return BAT_LOAD_DVR_IDLE;   // BOOTING / IDLE / LOW_BAT / ERROR: DVR powered
+    }
+}
+
+// New load class: move the trip, restart bucket stability after the settle
+static void on_load_change(uint32_t now_ms, bat_load_t load)
+{
+    g_load = load;
+
+    if (!g_lockout_active && hw_adc_trip_disarm())
+        arm_lockout_trip();
+
+    g_candidate_count = 0;
+    g_settle_until    = now_ms + (uint32_t)T_BAT_LOAD_SETTLE_MS;
+}
+
 static inline battery_state_t classify_battery(uint16_t adc)
 {
     // Ordered high -> low; uses thresholds.h exactly.
     // NOTE: If you have ADC_CRITICAL and want a separate bucket, add that here
     //       and ensure enums.h includes the matching battery_state_t.
-    if (adc >= ADC_FULL) return BAT_FULL;
-    if (adc >= ADC_HALF) return BAT_HALF;
-    if (adc >= ADC_LOW)  return BAT_LOW;
+    if (adc >= ADC_OS(ADC_FULL)) return BAT_FULL;
+    if (adc >= ADC_OS(ADC_HALF)) return BAT_HALF;
+    if (adc >= ADC_OS(ADC_LOW))  return BAT_LOW;
     return BAT_CRITICAL;
 }
 
@@ -89,12 +257,12 @@ static inline bool classify_lockout(bool currently_lockout, uint16_t adc)
     if (!currently_lockout)
     {
         // Enter lockout at or below enter threshold.
-        return (adc <= ADC_LOCKOUT_ENTER);
+        return (adc <= ADC_OS(ADC_LOCKOUT_ENTER));
     }
     else
     {
         // Exit lockout only when we recover to or above exit threshold.
-        return (adc < ADC_LOCKOUT_EXIT);
+        return (adc < ADC_OS(ADC_LOCKOUT_EXIT));
     }
 }
 
@@ -104,9 +272,20 @@ static inline bool classify_lockout(bool currently_lockout, uint16_t adc)
 void drv_fuel_gauge_init(void)
 {
     pinMode(PIN_FUELGAUGE_ADC, INPUT);
+    hw_adc_init();
 
     g_next_sample_ms = 0;
     g_last_adc       = 0;
+    g_est_adc        = 0;
+    g_bandgap        = HW_ADC_BG_NOMINAL;
+    g_last_raw       = 0;
+    g_cal_m1         = 0;
+    g_cal_t1         = 0;
+    (void)bat_cal_load(&g_cal);
+    rebuild_scale();
+    g_load           = BAT_LOAD_REST;
+    g_settle_until   = 0;
+    g_fsm_state      = STATE_OFF;
 
     g_reported_state  = BAT_UNKNOWN;
     g_candidate_state = BAT_UNKNOWN;
@@ -115,30 +294,94 @@ void drv_fuel_gauge_init(void)
     g_lockout_active          = false;
     g_lockout_candidate       = false;
     g_lockout_candidate_count = 0;
+
+    g_runtime_warned = false;
+    bat_runtime_init();
+
+    g_fast_tripped = false;
+    arm_lockout_trip();
 }
 
 void drv_fuel_gauge_poll(uint32_t now_ms)
 {
+    // Fast path fired: adopt lockout as if the polled path had confirmed it,
+    // so exit runs through the usual hysteresis + stability requirement.
+    if (g_fast_tripped)
+    {
+        g_fast_tripped            = false;
+        g_lockout_active          = true;
+        g_lockout_candidate       = true;
+        g_lockout_candidate_count = kStableSamplesReq;
+    }
+
     if ((int32_t)(now_ms - g_next_sample_ms) < 0)
         return;
 
+    // Latest 16-sample result (one every ~16 ms); none yet => try next loop
+    uint16_t adc;
+    if (!hw_adc_take(&adc))
+        return;
+
     g_next_sample_ms = now_ms + (uint32_t)kSamplePeriodMs;
 
-    // Take one ADC sample (0..1023).
-    const uint16_t adc = (uint16_t)analogRead(PIN_FUELGAUGE_ADC);
+    // -------------------------
+    // Supply drift + per-unit calibration; the trip follows both
+    // -------------------------
+    const uint16_t bg = hw_adc_bandgap();
+    if (bg >= HW_ADC_BG_MIN && bg <= HW_ADC_BG_MAX)
+        g_bandgap = bg;
+    if (g_bandgap != g_scale_bg)
+        rebuild_scale();
+
+    g_last_raw = adc;
+    adc = calibrate(adc);
     g_last_adc = adc;
 
+    // -------------------------
+    // Load compensation: everything below works on the open-circuit estimate
+    // -------------------------
+    const bat_load_t load = current_load();
+    if (load != g_load)
+        on_load_change(now_ms, load);
+    else
+        hw_adc_trip_set_level(trip_level());
+
+    const uint16_t est = (uint16_t)(adc + kSagCounts[g_load]);
+    g_est_adc = est;
+
+    // -------------------------
+    // Recording time left: warn once, re-arm with margin
+    // -------------------------
+    bat_runtime_update(est);
+    const uint16_t minutes = bat_runtime_rec_minutes();
+
+    if (!g_runtime_warned && !g_lockout_active && minutes <= BAT_REC_WARN_MIN)
+    {
+        g_runtime_warned = true;
+        emit_bat_event(now_ms,
+                       EV_BAT_RUNTIME_LOW,
+                       EVR_HYSTERESIS,
+                       minutes,
+                       bat_runtime_soc_permille());
+    }
+    else if (g_runtime_warned && minutes >= BAT_REC_WARN_REARM_MIN)
+    {
+        g_runtime_warned = false;
+    }
+
     // -------------------------
     // Battery state classification with stability requirement
+    // (not counted while the pack settles after a load change)
     // -------------------------
-    const battery_state_t s = classify_battery(adc);
+    const battery_state_t s = classify_battery(est);
+    const bool settled = (int32_t)(now_ms - g_settle_until) >= 0;
 
     if (s != g_candidate_state)
     {
         g_candidate_state = s;
-        g_candidate_count = 1;
+        g_candidate_count = settled ? 1 : 0;
     }
-    else
+    else if (settled)
     {
         if (g_candidate_count < 255) g_candidate_count++;
     }
@@ -152,13 +395,13 @@ void drv_fuel_gauge_poll(uint32_t now_ms)
                        EV_BAT_STATE_CHANGED,
                        EVR_CLASSIFIER_STABLE,
                        (uint16_t)g_reported_state,
-                       adc);
+                       est);
     }
 
     // -------------------------
     // Lockout hysteresis + stability requirement
     // -------------------------
-    const bool lockout_now = classify_lockout(g_lockout_active, adc);
+    const bool lockout_now = classify_lockout(g_lockout_active, est);
 
     if (lockout_now != g_lockout_candidate)
     {
@@ -174,12 +417,20 @@ void drv_fuel_gauge_poll(uint32_t now_ms)
     {
         g_lockout_active = g_lockout_candidate;
 
+        // Slow sag beat the trip: take over. If the trip fired meanwhile it
+        // has already reported this entry.
+        if (g_lockout_active && !hw_adc_trip_disarm())
+            return;
+
         // arg0=state (at time), arg1=adc
         emit_bat_event(now_ms,
                        g_lockout_active ? EV_BAT_LOCKOUT_ENTER : EV_BAT_LOCKOUT_EXIT,
                        EVR_HYSTERESIS,
                        (uint16_t)g_reported_state,
-                       adc);
+                       est);
+
+        if (!g_lockout_active)
+            arm_lockout_trip();
     }
 }
 
@@ -188,6 +439,83 @@ uint16_t drv_fuel_gauge_last_adc(void)
     return g_last_adc;
 }
 
+uint16_t drv_fuel_gauge_est_adc(void)
+{
+    return g_est_adc;
+}
+
+bool drv_fuel_gauge_cal_point(uint16_t pack_mv)
+{
+    if (g_last_raw == 0)
+        return false;
+
+    // m: what the uncalibrated gauge reads, t: what it should read
+    const uint16_t m = ratio_correct(g_last_raw, g_bandgap);
+    const uint16_t t = ADC_OS_MV(pack_mv);
+    if (m == 0)
+        return false;
+    const int32_t  dt = (int32_t)t - (int32_t)g_cal_t1;
+    const int32_t  dm = (int32_t)m - (int32_t)g_cal_m1;
+    const int32_t  span = (int32_t)ADC_OS_MV(BAT_CAL_SPAN_MIN_MV);
+
+    bat_cal_t c;
+    if (g_cal_m1 != 0 && dm != 0 && (dt >= span || dt <= -span))
+    {
+        // Two-point: slope through both, line through the newest
+        const int32_t g = (dt * (int32_t)BAT_CAL_GAIN_ONE) / dm;
+        if (g <= 0 || g > 0xFFFF)
+            return false;
+        c.gain_q14 = (uint16_t)g;
+        c.offset   = (int16_t)((int32_t)t - (((int32_t)m * g + 8192) >> 14));
+    }
+    else
+    {
+        c.gain_q14 = (uint16_t)((((uint32_t)t << 14) + (m >> 1)) / m);
+        c.offset   = 0;
+    }
+
+    if (!bat_cal_plausible(&c))
+        return false;
+
+    g_cal_m1 = m;
+    g_cal_t1 = t;
+
+    g_cal = c;
+    bat_cal_save(&g_cal);
+    rebuild_scale();
+    return true;
+}
+
+void drv_fuel_gauge_cal_clear(void)
+{
+    bat_cal_erase();
+    g_cal.gain_q14 = BAT_CAL_GAIN_ONE;
+    g_cal.offset   = 0;
+    g_cal_m1       = 0;
+    g_cal_t1       = 0;
+    rebuild_scale();
+}
+
+void drv_fuel_gauge_cal_get(bat_cal_t* out)
+{
+    *out = g_cal;
+}
+
+uint16_t drv_fuel_gauge_vcc_mv(void)
+{
+    return (uint16_t)((1100UL * HW_ADC_MAX + (g_bandgap >> 1)) / g_bandgap);
+}
+
+bat_load_t drv_fuel_gauge_load(void)
+{
+    return g_load;
+}
+
+void drv_fuel_gauge_set_fsm_state(controller_state_t st)
+{
+    g_fsm_state = st;
+}
+
 battery_state_t drv_fuel_gauge_last_state(void)
 {
     return g_reported_state;
@@ -1,13 +1,25 @@
 // dvr_button.cpp
 //
 // Button driver for LTC2954 INT#-qualified button input.
-// - Polling-based edge detect + debounce (NO ISR ownership)
-// - Emits gesture events:
+// - INT0 any-change ISR owns the pin: each transition is stamped with Timer1
+//   (0.5 us) into a small ring; button_poll() drains it
+// - Debounce + gesture classification run on those timestamps, so press
+//   durations do not depend on loop latency, and no edge needs the loop awake
+// - Emits gesture events (t_ms = time of the edge, not of the poll):
 //      EV_BTN_SHORT_PRESS on release if duration within [T_BTN_SHORT_MIN_MS .. T_BTN_GRACE_MS)
 //      EV_BTN_LONG_PRESS  once when held reaches T_BTN_GRACE_MS (early emit), OR on release if held >= T_BTN_GRACE_MS and not yet emitted
 // - Optional raw edge telemetry (EV_LTC_INT_ASSERTED / EV_LTC_INT_DEASSERTED)
 //
-// Dependencies: pins.h, timings.h, enums.h, event_queue.h
+// Debounce (same semantics as the former polled version, on edge times):
+//   an edge to the other level is taken if it lies >= T_BTN_DEBOUNCE_MS after
+//   the last taken edge. If the bounce settles on the other level inside that
+//   window, the last raw edge is taken once the window has passed. A level
+//   the ring never saw (overflow) is taken from the pin itself.
+//
+// Ownership: INT0 (PD2) and its vector. Any sleep mode that keeps the I/O
+// clock running (IDLE) wakes on a press; do not attachInterrupt() on D2.
+//
+// Dependencies: pins.h, timings.h, enums.h, event_queue.h, hw_timer.h
 //
 
 #include <Arduino.h>
@@ -17,6 +29,11 @@
 #include "timings.h"
 #include "enums.h"
 #include "event_queue.h"
+#include "hw_timer.h"
+
+#ifdef __AVR__
+  #include <avr/interrupt.h>
+#endif
 
 // -----------------------------------------------------------------------------
 // Optional debug telemetry
@@ -25,22 +42,96 @@
 #define CFG_BUTTON_EMIT_RAW_EDGES 0
 #endif
 
+static const uint32_t DEBOUNCE_TK = (uint32_t)T_BTN_DEBOUNCE_MS * HW_TIMER_TICKS_PER_MS;
+static const uint32_t GRACE_TK    = (uint32_t)T_BTN_GRACE_MS * HW_TIMER_TICKS_PER_MS;
+
+// Idle edge reference is kept this young, so the 35.8 min Timer1 wrap can
+// never alias an old reference into the debounce window.
+static const uint32_t REF_AGE_CAP_TK = 1000UL * HW_TIMER_TICKS_PER_MS;
+
 // -----------------------------------------------------------------------------
-// Internal state
+// ISR capture ring: one uint32_t per edge
+//   bits 31..1 : Timer1 tick of the edge (bit 0 of the tick is dropped)
+//   bit 0      : level AFTER the edge
+// A press with bounce is ~2..10 edges; 8 slots cover one bouncy edge between
+// two polls even at a 35 ms loop. On overflow the newest slot is overwritten
+// (counted): the ring still ends on the latest level and time.
 // -----------------------------------------------------------------------------
-static uint8_t  g_last_level         = HIGH;
-static uint32_t g_last_edge_ms       = 0;
+static const uint8_t BN = 8;   // power-of-two required
+
+static volatile uint32_t s_cap[BN];
+static volatile uint8_t  s_cap_w       = 0;
+static volatile uint8_t  s_cap_r       = 0;
+static volatile uint16_t s_cap_dropped = 0;   // saturating
+
+// -----------------------------------------------------------------------------
+// Internal state (main loop; times in Timer1 ticks)
+// -----------------------------------------------------------------------------
+static uint8_t  g_raw_level          = HIGH;   // level after the newest raw edge
+static uint32_t g_raw_tk             = 0;
+
+static uint8_t  g_level              = HIGH;   // debounced level
+static uint32_t g_level_tk           = 0;      // when it was taken
 
 static bool     g_pressed            = false;
-static uint32_t g_down_ms            = 0;
+static uint32_t g_down_tk            = 0;
 
 static bool     g_long_emitted       = false;  // emitted EV_BTN_LONG_PRESS for this press instance?
 static uint16_t g_last_press_ms      = 0;
 
+// -----------------------------------------------------------------------------
+// INT0 edge capture: sample PD2 first (closest to the edge), then Timer1.
+// -----------------------------------------------------------------------------
+#ifdef __AVR__
+ISR(INT0_vect)
+{
+    const uint8_t  lvl = LTC_INT_LEVEL();
+    const uint32_t tk  = hw_timer_now32_isr();
+
+    const uint32_t slot = (tk & ~1UL) | (lvl ? 1UL : 0UL);
+
+    const uint8_t w = s_cap_w;
+    const uint8_t n = (uint8_t)((w + 1u) & (BN - 1u));
+    if (n == s_cap_r)
+    {
+        s_cap[(uint8_t)((w - 1u) & (BN - 1u))] = slot;   // coalesce into newest
+        if (s_cap_dropped != 0xFFFFu) s_cap_dropped++;
+        return;
+    }
+
+    s_cap[w] = slot;
+    s_cap_w  = n;
+}
+#endif
+
+static inline void int0_enable_any_change(void)
+{
+#ifdef __AVR__
+    EICRA = (uint8_t)((EICRA & ~(_BV(ISC01) | _BV(ISC00))) | _BV(ISC00));   // any logical change
+    EIFR  = _BV(INTF0);                                                     // drop stale request
+    EIMSK |= _BV(INT0);
+#endif
+}
+
+static bool pop_edge(uint32_t &slot)
+{
+    noInterrupts();
+    if (s_cap_r == s_cap_w)
+    {
+        interrupts();
+        return false;
+    }
+    const uint8_t r = s_cap_r;
+    slot    = s_cap[r];
+    s_cap_r = (uint8_t)((r + 1u) & (BN - 1u));
+    interrupts();
+    return true;
+}
+
 // -----------------------------------------------------------------------------
 // Helpers
 // -----------------------------------------------------------------------------
-static inline void emit(uint32_t now_ms,
+static inline void emit(uint32_t t_ms,
                         event_id_t id,
                         event_source_t src,
                         event_reason_t reason,
@@ -48,7 +139,7 @@ static inline void emit(uint32_t now_ms,
                         uint16_t arg1)
 {
     event_t e;
-    e.t_ms   = now_ms;
+    e.t_ms   = t_ms;
     e.id     = id;
     e.src    = src;
     e.reason = reason;
@@ -67,105 +158,158 @@ static inline bool is_asserted(uint8_t level)
     return (level == (uint8_t)LTC_INT_ASSERT_LEVEL);
 }
 
+// millis() domain time of a past tick stamp
+static inline uint32_t tk_to_ms(uint32_t now_ms, uint32_t now_tk, uint32_t tk)
+{
+    return now_ms - (now_tk - tk) / HW_TIMER_TICKS_PER_MS;
+}
+
+// Debounced edge at tk
+static void take_edge(uint32_t now_ms, uint32_t now_tk, uint8_t level, uint32_t tk)
+{
+    const uint32_t t_ms = tk_to_ms(now_ms, now_tk, tk);
+
+    g_level    = level;
+    g_level_tk = tk;
+
+#if (CFG_BUTTON_EMIT_RAW_EDGES != 0)
+    // Raw edge telemetry (debug only)
+    if (is_asserted(level))
+    {
+        emit(t_ms, EV_LTC_INT_ASSERTED, SRC_LTC, EVR_EDGE_FALL, (uint16_t)level, 0);
+    }
+    else
+    {
+        emit(t_ms, EV_LTC_INT_DEASSERTED, SRC_LTC, EVR_EDGE_RISE, (uint16_t)level, 0);
+    }
+#endif
+
+    // Press tracking
+    if (is_asserted(level))
+    {
+        // Press down
+        g_pressed      = true;
+        g_down_tk      = tk;
+        g_long_emitted = false;
+        return;
+    }
+
+    // Release
+    if (g_pressed)
+    {
+        const uint16_t press_ms = clamp_u16((tk - g_down_tk) / HW_TIMER_TICKS_PER_MS);
+        g_last_press_ms         = press_ms;
+
+        // If we already emitted LONG during hold, do not emit again.
+        if (!g_long_emitted)
+        {
+            if (press_ms >= (uint16_t)T_BTN_SHORT_MIN_MS &&
+                press_ms <  (uint16_t)T_BTN_GRACE_MS)
+            {
+                emit(t_ms, EV_BTN_SHORT_PRESS, SRC_BUTTON, EVR_INTERNAL, press_ms, 0);
+            }
+            else if (press_ms >= (uint16_t)T_BTN_GRACE_MS)
+            {
+                // Long press released before the early-emit path ran (poll stalled).
+                emit(t_ms, EV_BTN_LONG_PRESS, SRC_BUTTON, EVR_INTERNAL, press_ms, 0);
+            }
+            else
+            {
+                // Too short: ignore
+            }
+        }
+    }
+
+    g_pressed      = false;
+    g_long_emitted = false; // reset for next press
+}
+
 // -----------------------------------------------------------------------------
 // Public API
 // -----------------------------------------------------------------------------
 void button_init(void)
 {
-    // pins_init() is authoritative; assume already called.
-    const uint32_t now_ms = millis();
+    // pins_init() and hw_timer_init() are authoritative; assume already called.
+    const uint32_t now_tk = hw_timer_now32();
+
+    noInterrupts();
+    s_cap_w       = 0;
+    s_cap_r       = 0;
+    s_cap_dropped = 0;
+    interrupts();
 
-    g_last_level    = (uint8_t)digitalRead(PIN_LTC_INT_N);
-    g_last_edge_ms  = now_ms;
+    g_raw_level     = LTC_INT_LEVEL();
+    g_raw_tk        = now_tk;
+    g_level         = g_raw_level;
+    g_level_tk      = now_tk - DEBOUNCE_TK;   // first edge is taken at once
 
-    g_pressed       = is_asserted(g_last_level);
-    g_down_ms       = g_pressed ? now_ms : 0;
+    g_pressed       = is_asserted(g_level);
+    g_down_tk       = now_tk;
 
     g_long_emitted  = false;
     g_last_press_ms = 0;
+
+    int0_enable_any_change();
 }
 
 void button_poll(uint32_t now_ms)
 {
-    const uint8_t level = (uint8_t)digitalRead(PIN_LTC_INT_N);
-
     // -------------------------------------------------------------------------
-    // Edge detect + debounce
+    // Drain captured edges; debounce on their timestamps
     // -------------------------------------------------------------------------
-    if (level != g_last_level)
+    uint32_t slot;
+    while (pop_edge(slot))
     {
-        if ((uint32_t)(now_ms - g_last_edge_ms) >= (uint32_t)T_BTN_DEBOUNCE_MS)
-        {
-            g_last_edge_ms = now_ms;
-            g_last_level   = level;
+        const uint8_t  level = (slot & 1u) ? HIGH : LOW;
+        const uint32_t tk    = slot & ~1UL;
 
-#if (CFG_BUTTON_EMIT_RAW_EDGES != 0)
-            // Raw edge telemetry (debug only)
-            if (is_asserted(level))
-            {
-                emit(now_ms, EV_LTC_INT_ASSERTED, SRC_LTC, EVR_EDGE_FALL, (uint16_t)level, 0);
-            }
-            else
-            {
-                emit(now_ms, EV_LTC_INT_DEASSERTED, SRC_LTC, EVR_EDGE_RISE, (uint16_t)level, 0);
-            }
+        g_raw_level = level;
+        g_raw_tk    = tk;
+
+        if (level != g_level && (uint32_t)(tk - g_level_tk) >= DEBOUNCE_TK)
+            take_edge(now_ms, hw_timer_now32(), level, tk);
+    }
+
+    // Pin vs ring: only trusted with no edge queued or latched
+    bool idle;
+    uint8_t pin;
+    noInterrupts();
+    pin  = LTC_INT_LEVEL();
+#ifdef __AVR__
+    idle = (s_cap_r == s_cap_w) && !(EIFR & _BV(INTF0));
+#else
+    idle = (s_cap_r == s_cap_w);
 #endif
+    interrupts();
 
-            // Press tracking
-            if (is_asserted(level))
-            {
-                // Press down
-                g_pressed      = true;
-                g_down_ms      = now_ms;
-                g_long_emitted = false;
-            }
-            else
-            {
-                // Release
-                if (g_pressed)
-                {
-                    const uint32_t press_ms_u32 = (uint32_t)(now_ms - g_down_ms);
-                    const uint16_t press_ms     = clamp_u16(press_ms_u32);
-                    g_last_press_ms             = press_ms;
-
-                    // If we already emitted LONG during hold, do not emit again.
-                    if (!g_long_emitted)
-                    {
-                        if (press_ms >= (uint16_t)T_BTN_SHORT_MIN_MS &&
-                            press_ms <  (uint16_t)T_BTN_GRACE_MS)
-                        {
-                            emit(now_ms, EV_BTN_SHORT_PRESS, SRC_BUTTON, EVR_INTERNAL, press_ms, 0);
-                        }
-                        else if (press_ms >= (uint16_t)T_BTN_GRACE_MS)
-                        {
-                            // Long press released before we hit the early-emit path (e.g. low poll rate).
-                            emit(now_ms, EV_BTN_LONG_PRESS, SRC_BUTTON, EVR_INTERNAL, press_ms, 0);
-                            g_long_emitted = true;
-                        }
-                        else
-                        {
-                            // Too short: ignore
-                        }
-                    }
-                }
-
-                g_pressed      = false;
-                g_down_ms      = 0;
-                g_long_emitted = false; // reset for next press
-            }
-        }
+    const uint32_t now_tk = hw_timer_now32();
+
+    if (idle && pin != g_raw_level)
+    {
+        // Backstop: the pin is authoritative once nothing is pending
+        g_raw_level = pin;
+        g_raw_tk    = now_tk;
     }
 
+    // Bounce ended on the other level inside the window: take its last edge
+    if (g_raw_level != g_level && (uint32_t)(now_tk - g_level_tk) >= DEBOUNCE_TK)
+        take_edge(now_ms, now_tk, g_raw_level, g_raw_tk);
+
+    if (!g_pressed && (uint32_t)(now_tk - g_level_tk) > REF_AGE_CAP_TK)
+        g_level_tk = now_tk - REF_AGE_CAP_TK;
+
     // -------------------------------------------------------------------------
     // Grace-hold early emit (software shutdown before LTC nuclear)
     // -------------------------------------------------------------------------
     if (g_pressed && !g_long_emitted)
     {
-        const uint32_t held_ms = (uint32_t)(now_ms - g_down_ms);
+        const uint32_t held_tk = now_tk - g_down_tk;
 
-        if (held_ms >= (uint32_t)T_BTN_GRACE_MS)
+        if (held_tk >= GRACE_TK)
         {
-            emit(now_ms, EV_BTN_LONG_PRESS, SRC_BUTTON, EVR_TIMEOUT, clamp_u16(held_ms), 0);
+            emit(tk_to_ms(now_ms, now_tk, g_down_tk + GRACE_TK),
+                 EV_BTN_LONG_PRESS, SRC_BUTTON, EVR_TIMEOUT,
+                 clamp_u16(held_tk / HW_TIMER_TICKS_PER_MS), 0);
             g_long_emitted = true;
         }
 
@@ -182,3 +326,12 @@ uint16_t button_last_press_ms(void)
 {
     return g_last_press_ms;
 }
+
+uint16_t button_dropped_edges(void)
+{
+    uint16_t v;
+    noInterrupts();
+    v = s_cap_dropped;
+    interrupts();
+    return v;
+}
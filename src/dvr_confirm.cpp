@@ -0,0 +1,194 @@
+// dvr_confirm.cpp
+//
+// Closed-loop DVR gesture confirmation (see dvr_confirm.h).
+//
+// One gesture in flight at a time (the FSM never overlaps DVR gestures; a new
+// one simply replaces the old). Everything is main-loop context.
+
+#include "dvr_confirm.h"
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "timings.h"
+#include "drv_dvr_status.h"
+#include "dvr_led.h"
+
+// -----------------------------------------------------------------------------
+// Internal state
+// -----------------------------------------------------------------------------
+static dvr_gesture_t     s_gest        = DVR_GEST_NONE;
+static dvr_led_pattern_t s_expect      = DVR_LED_UNKNOWN;
+static dvr_led_pattern_t s_before      = DVR_LED_UNKNOWN;   // LED when (re)issued
+static dvr_led_pattern_t s_before_cls  = DVR_LED_UNKNOWN;   // classifier pattern then
+static bool              s_blinking    = false;             // LED already blinking then
+static uint16_t          s_edges0      = 0;                 // dvr_led_edge_count() then
+static bool              s_reacted     = false;             // LED moved since
+static bool              s_grace       = false;             // reacted: one extra window used
+static uint8_t           s_retries     = 0;                 // re-presses so far
+static uint32_t          s_deadline_ms = 0;
+
+static dvr_confirm_stats_t s_stats;
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+static inline bool time_reached(uint32_t now, uint32_t deadline)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+static inline void stat_inc(uint16_t& c)
+{
+    if (c != 0xFFFFu) c++;
+}
+
+static inline bool is_blink(dvr_led_pattern_t p)
+{
+    return (p == DVR_LED_SLOW_BLINK) || (p == DVR_LED_FAST_BLINK);
+}
+
+static dvr_led_pattern_t gesture_expect(dvr_gesture_t g)
+{
+    switch (g)
+    {
+        case DVR_GEST_REC_START: return DVR_LED_SLOW_BLINK;
+        case DVR_GEST_REC_STOP:  return DVR_LED_SOLID;
+        case DVR_GEST_POWER_ON:  return DVR_LED_SOLID;
+        case DVR_GEST_POWER_OFF: return DVR_LED_OFF;
+        default:                 return DVR_LED_UNKNOWN;
+    }
+}
+
+static uint16_t gesture_deadline_ms(dvr_gesture_t g)
+{
+    switch (g)
+    {
+        case DVR_GEST_REC_START: return T_CONFIRM_REC_START_MS;
+        case DVR_GEST_REC_STOP:  return T_CONFIRM_REC_STOP_MS;
+        case DVR_GEST_POWER_ON:  return T_CONFIRM_POWER_ON_MS;
+        case DVR_GEST_POWER_OFF: return T_CONFIRM_POWER_OFF_MS;
+        default:                 return 0;
+    }
+}
+
+// (Re)start the observation window for the press just queued
+static void arm(uint32_t now_ms)
+{
+    s_before      = drv_dvr_status_last_led_pattern();
+    s_before_cls  = dvr_led_get_pattern();
+    s_blinking    = is_blink(s_before) || is_blink(s_before_cls);
+    s_edges0      = dvr_led_edge_count();
+    s_reacted     = false;
+    s_grace       = false;
+    s_deadline_ms = now_ms + (uint32_t)gesture_deadline_ms(s_gest);
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+void dvr_confirm_init(void)
+{
+    s_gest    = DVR_GEST_NONE;
+    s_expect  = DVR_LED_UNKNOWN;
+    s_before  = DVR_LED_UNKNOWN;
+    s_before_cls = DVR_LED_UNKNOWN;
+    s_blinking   = false;
+    s_edges0  = 0;
+    s_reacted = false;
+    s_grace   = false;
+    s_retries = 0;
+    s_deadline_ms = 0;
+
+    s_stats.issued    = 0;
+    s_stats.confirmed = 0;
+    s_stats.retries   = 0;
+    s_stats.failed    = 0;
+}
+
+void dvr_confirm_start(uint32_t now_ms, dvr_gesture_t g)
+{
+    if (g == DVR_GEST_NONE)
+        return;
+
+    s_gest    = g;
+    s_expect  = gesture_expect(g);
+    s_retries = 0;
+    arm(now_ms);
+
+    stat_inc(s_stats.issued);
+}
+
+void dvr_confirm_cancel(void)
+{
+    s_gest = DVR_GEST_NONE;
+}
+
+dvr_gesture_t dvr_confirm_poll(uint32_t now_ms)
+{
+    if (s_gest == DVR_GEST_NONE)
+        return DVR_GEST_NONE;
+
+    const dvr_led_pattern_t p = drv_dvr_status_last_led_pattern();
+
+    if (p == s_expect)
+    {
+        stat_inc(s_stats.confirmed);
+        s_gest = DVR_GEST_NONE;
+        return DVR_GEST_NONE;
+    }
+
+    // From a steady LED any edge counts: a blink shows edges well before it
+    // commits, and a toggle that did register must not be pressed again (it
+    // would undo it). An LED that was already blinking (REC_STOP, POWER_OFF
+    // while recording) makes edges on its own: there only a pattern change
+    // counts, including the classifier seeing the blink end.
+    if (p != s_before)
+        s_reacted = true;
+    else if (s_blinking)
+    {
+        if (dvr_led_get_pattern() != s_before_cls)
+            s_reacted = true;
+    }
+    else if (dvr_led_edge_count() != s_edges0)
+        s_reacted = true;
+
+    if (!time_reached(now_ms, s_deadline_ms))
+        return DVR_GEST_NONE;
+
+    // Deadline: no reaction at all => the press did not register, try again
+    if (!s_reacted && s_retries < (uint8_t)CFG_DVR_CONFIRM_RETRIES)
+    {
+        s_retries++;
+        stat_inc(s_stats.retries);
+        arm(now_ms);
+        return s_gest;
+    }
+
+    // Reacted but still settling (slow commit): one more window, no press
+    if (s_reacted && !s_grace)
+    {
+        s_grace       = true;
+        s_deadline_ms = now_ms + (uint32_t)gesture_deadline_ms(s_gest);
+        return DVR_GEST_NONE;
+    }
+
+    stat_inc(s_stats.failed);
+    s_gest = DVR_GEST_NONE;
+    return DVR_GEST_NONE;
+}
+
+bool dvr_confirm_is_long(dvr_gesture_t g)
+{
+    return (g == DVR_GEST_POWER_ON) || (g == DVR_GEST_POWER_OFF);
+}
+
+dvr_gesture_t dvr_confirm_pending(void)
+{
+    return s_gest;
+}
+
+void dvr_confirm_get_stats(dvr_confirm_stats_t* out)
+{
+    *out = s_stats;
+}
@@ -2,12 +2,25 @@
 //
 //
 // What this module IS:
-//  - A *signal classifier* only: OFF / SOLID / SLOW_BLINK / FAST_BLINK / UNKNOWN
-//  - Uses Arduino attachInterrupt() on PIN_DVR_STAT (INT1 on Nano / ATmega328P)
+//  - A *signal classifier* only: LED timing -> dvr_led_pattern_t
+//  - Owns the INT1 vector directly (PIN_DVR_STAT = PD3, any-change trigger)
 //  - LOW = DVR LED ON (per your NPN mirror)
-//  - Edge-timestamp ring buffer (micros) => robust periods/duty even if loop jitters
+//  - Constant-size incremental classifier core (classify_edge) fed one edge at
+//    a time, in 128 us units, with no divisions. Two build modes:
+//      CFG_DVR_LED_ISR_CLASSIFIER == 0: ISR fills a ring of packed 16-bit
+//        deltas (GAP marker on overflow); dvr_led_poll() drains it.
+//      CFG_DVR_LED_ISR_CLASSIFIER == 1: the INT1 ISR runs the core directly
+//        and publishes one pattern byte + one confidence byte. No ring, no
+//        drain; the main loop only does the quiet-time check.
+//  - Self-calibration (CFG_DVR_LED_SELF_CAL): ON/OFF halves learned during
+//    steady confirmed blinks re-centre and tighten the press-commit envelope
+//    around the attached DVR; persisted via led_cal.
+//  - Edge-storm guard (CFG_DVR_LED_STORM_GUARD): a chattering line masks INT1
+//    and falls back to a 1 kHz Timer2 majority-filtered sampler until clean.
 //  - Sticky blink: once in blink, never overwritten by OFF/SOLID until truly quiet
-//  - Classification uses timings.h thresholds (period + optional edge bounds)
+//  - Classification is data-driven: a flash-resident signature table (period,
+//    ON/OFF half windows, burst length, terminal level) matched in one pass per
+//    edge. A new DVR behaviour is a table row, not new code.
 //
 // GO and look at dvr_dvr_status for:
 //  - infer "abnormal boot" or any higher-level meaning.
@@ -21,6 +34,8 @@
 //  - dvr_led_init()
 //  - dvr_led_poll(now_ms)
 //  - dvr_led_get_pattern()
+//
+// Patterns produced: OFF / SOLID / SLOW_BLINK / FAST_BLINK / ABNORMAL_BOOT / UNKNOWN
 
 #include <Arduino.h>
 
@@ -28,284 +43,1112 @@
 #include "pins.h"
 #include "timings.h"
 #include "enums.h"
+#include "hw_timer.h"
+#include "isr_stats.h"
+#include "config.h"
+#include "led_cal.h"
+
+#ifdef __AVR__
+  #include <avr/interrupt.h>
+  #include <avr/pgmspace.h>
+#endif
 
 // -----------------------------------------------------------------------------
 // Local hygiene only (NOT a system timing constant)
 // -----------------------------------------------------------------------------
-static const uint16_t DVR_LED_GLITCH_US = 3000; // reject edges closer than 3ms
+static const uint16_t DVR_LED_GLITCH_TK = 3u * HW_TIMER_TICKS_PER_MS; // reject edges closer than 3ms
 
 // -----------------------------------------------------------------------------
-// ISR ring buffer (timestamps + level-after-edge)
+// Edge time unit: 128 us (Timer1 ticks >> 8). All classifier arithmetic is
+// uint16_t in these units (max 0x7FFF ~ 4.19 s, saturating).
 // -----------------------------------------------------------------------------
-static const uint8_t QN = 32;                  // power-of-two recommended
-static volatile uint32_t s_q_ts_us[QN];
-static volatile uint8_t  s_q_lvl[QN];
-static volatile uint8_t  s_q_w = 0;
-static volatile uint8_t  s_q_r = 0;
+static const uint8_t  U_SHIFT = 8;            // ticks -> units
+static const uint16_t U_MAX   = 0x7FFFu;      // saturated duration
 
-static volatile uint32_t s_last_isr_us = 0;
+#define LED_MS_TO_U(ms)  ((uint16_t)(((uint32_t)(ms) * 1000u + 64u) / 128u))
+#define LED_MS_TO_TK(ms) ((uint32_t)(ms) * HW_TIMER_TICKS_PER_MS)
 
-static void dvr_led_isr_change()
+static inline uint16_t tk_to_u_sat(uint32_t dt_tk)
 {
-    const uint32_t now_us = micros();
-    const uint32_t dt_us  = now_us - s_last_isr_us;
-    if (dt_us < DVR_LED_GLITCH_US)
-        return;
+    const uint32_t u = dt_tk >> U_SHIFT;
+    return (u >= U_MAX) ? U_MAX : (uint16_t)u;
+}
 
-    s_last_isr_us = now_us;
+static volatile uint32_t s_last_isr_tk = 0;   // ISR glitch/delta reference
 
-    const uint8_t w = s_q_w;
-    const uint8_t w_next = (uint8_t)((w + 1u) & (QN - 1u));
-    if (w_next == s_q_r)
-        return; // overflow => drop (rare, but safe)
+// -----------------------------------------------------------------------------
+// Classifier state (owned by ISR in ISR mode, by dvr_led_poll in ring mode)
+// -----------------------------------------------------------------------------
+static volatile dvr_led_pattern_t s_pat  = DVR_LED_UNKNOWN;  // published byte
+static volatile uint8_t           s_conf = 0;                // published byte
+static volatile uint32_t          s_pat_tk = 0;              // when s_pat last changed (Timer1 ticks)
+static volatile uint8_t           s_blink_edges = 0;         // edges since a blink committed (sat)
+static volatile uint16_t          s_edge_count  = 0;         // classified edges (wrapping)
+
+static uint8_t  s_prev_level = HIGH;   // level held BEFORE current edge
+static bool     s_resync     = true;   // next edge only re-establishes level
 
-    s_q_ts_us[w]  = now_us;
-    s_q_lvl[w]    = (uint8_t)digitalRead(PIN_DVR_STAT); // level AFTER edge
-    s_q_w         = w_next;
+// Last measured adjacent-edge durations (units); 0 = not yet measured.
+// Same-phase period = on + off (no absolute timestamps needed).
+static uint16_t s_on_dur_u     = 0;
+static uint16_t s_off_dur_u    = 0;
+static uint16_t s_last_period_u = 0;
+static uint16_t s_blink_period_u = 0;   // last period that matched the current blink
+
+// Current run of consecutive matching periods (finite bursts only). One mask
+// bit per signature: the rows that matched *every* period of the run.
+static uint8_t s_run_mask  = 0;
+static uint8_t s_run_len   = 0;
+static bool    s_run_clean = false;   // run began while not already blinking
+static uint8_t s_pat_sig   = 0xFFu;   // row that produced s_pat (SIG_NONE = quiet/unknown)
+
+// Last accepted edge time (Timer1 ticks, for quiet-time)
+static volatile uint32_t s_last_edge_tk = 0;
+
+// Prior: time of our own last record-toggle press (Timer1 ticks)
+static volatile uint32_t s_press_tk    = 0;
+static volatile bool     s_press_valid = false;
+
+static inline bool in_blink(dvr_led_pattern_t p)
+{
+    return (p == DVR_LED_SLOW_BLINK) || (p == DVR_LED_FAST_BLINK);
 }
 
-static bool pop_edge(uint32_t &ts_us, uint8_t &lvl_after)
+// Publish a pattern; the change time is the signal time that decided it
+// (committing edge, or quiet deadline), not when anyone polled.
+static inline void pat_set(dvr_led_pattern_t p, uint32_t at_tk)
 {
-    noInterrupts();
-    if (s_q_r == s_q_w)
+    if (p != s_pat)
     {
-        interrupts();
-        return false;
+        s_pat         = p;
+        s_pat_tk      = at_tk;
+        s_blink_edges = 0;
     }
-    const uint8_t r = s_q_r;
-    ts_us     = s_q_ts_us[r];
-    lvl_after = s_q_lvl[r];
-    s_q_r     = (uint8_t)((r + 1u) & (QN - 1u));
-    interrupts();
-    return true;
 }
 
-static inline void clear_queue()
+static inline bool in_range_u16(uint16_t v, uint16_t lo, uint16_t hi)
 {
-    noInterrupts();
-    s_q_r = s_q_w;
-    interrupts();
+    return (v >= lo) && (v <= hi);
 }
 
 // -----------------------------------------------------------------------------
-// Internal classifier state
+// Signature table (flash)
+//
+// Every full ON+OFF pair is matched against each row; a run keeps the rows
+// that matched every period so far. Table order is priority.
+//
+//   per_*     : same-phase period window (ON + OFF)
+//   on_*      : LED-ON half window  } together: duty range
+//   off_*     : LED-OFF half window }
+//   burst_min : matching periods required to commit
+//   burst_max : 0 = continuous pattern, committed while edges flow;
+//               N = finite burst of at most N periods, committed only when the
+//                   LED then settles at `terminal` (quiet-time)
+//   terminal  : settled level that ends a burst (SIG_TERM_*)
+//   flags     : SIG_F_PRESS_COMMIT = one tight pair commits after our press
+//   cal       : led_cal slot learned for this row (SIG_NO_CAL = none)
 // -----------------------------------------------------------------------------
-static dvr_led_pattern_t s_pat = DVR_LED_UNKNOWN;
+enum : uint8_t
+{
+    SIG_TERM_NONE = 0,
+    SIG_TERM_OFF,
+    SIG_TERM_ON
+};
 
-static uint8_t  s_level = HIGH;        // last sampled instantaneous level
-static uint32_t s_last_edge_ms = 0;    // last accepted edge time (ms, for quiet-time)
-static uint32_t s_prev_edge_us = 0;    // previous edge timestamp (us)
-static uint8_t  s_prev_level = HIGH;   // level held BEFORE current edge
+static const uint8_t SIG_F_PRESS_COMMIT = 0x01u;
+static const uint8_t SIG_NONE           = 0xFFu;
+static const uint8_t SIG_NO_CAL         = 0xFFu;
+
+typedef struct
+{
+    uint16_t per_min_u, per_max_u;
+    uint16_t on_min_u,  on_max_u;
+    uint16_t off_min_u, off_max_u;
+    uint8_t  burst_min;
+    uint8_t  burst_max;
+    uint8_t  terminal;
+    uint8_t  flags;
+    uint8_t  result;      // dvr_led_pattern_t
+    uint8_t  cal;
+} led_sig_t;
+
+static const led_sig_t k_sigs[] PROGMEM =
+{
+    // FAST_BLINK: error / update / shutdown burst
+    { LED_MS_TO_U(T_FAST_MIN_MS),      LED_MS_TO_U(T_FAST_MAX_MS),
+      LED_MS_TO_U(T_FAST_EDGE_MIN_MS), LED_MS_TO_U(T_FAST_EDGE_MAX_MS),
+      LED_MS_TO_U(T_FAST_EDGE_MIN_MS), LED_MS_TO_U(T_FAST_EDGE_MAX_MS),
+      2, 0, SIG_TERM_NONE, 0, DVR_LED_FAST_BLINK, 0 },
+
+    // SLOW_BLINK: recording
+    { LED_MS_TO_U(T_SLOW_MIN_MS),      LED_MS_TO_U(T_SLOW_MAX_MS),
+      LED_MS_TO_U(T_SLOW_EDGE_MIN_MS), LED_MS_TO_U(T_SLOW_EDGE_MAX_MS),
+      LED_MS_TO_U(T_SLOW_EDGE_MIN_MS), LED_MS_TO_U(T_SLOW_EDGE_MAX_MS),
+      2, 0, SIG_TERM_NONE, SIG_F_PRESS_COMMIT, DVR_LED_SLOW_BLINK, 1 },
 
-// For full-period (same-phase) timing
-static uint32_t s_last_on_us  = 0;     // last transition into ON (LOW)
-static uint32_t s_last_off_us = 0;     // last transition into OFF (HIGH)
+    // ABNORMAL_BOOT: ~2 s of slow blink from a non-blinking LED, then OFF
+    { LED_MS_TO_U(T_ABN_SLOW_MIN_MS),  LED_MS_TO_U(T_ABN_SLOW_MAX_MS),
+      LED_MS_TO_U(T_ABN_ON_MIN_MS),    LED_MS_TO_U(T_ABN_ON_MAX_MS),
+      LED_MS_TO_U(T_ABN_OFF_MIN_MS),   LED_MS_TO_U(T_ABN_OFF_MAX_MS),
+      1, T_ABN_BURST_PERIODS, SIG_TERM_OFF, 0, DVR_LED_ABNORMAL_BOOT, SIG_NO_CAL },
+};
 
-// Last measured durations (ms) (optional for debugging / future use)
-static uint16_t s_last_on_dur_ms  = 0;
-static uint16_t s_last_off_dur_ms = 0;
-static uint16_t s_last_period_ms  = 0;
+static const uint8_t SIG_COUNT = (uint8_t)(sizeof(k_sigs) / sizeof(k_sigs[0]));
+static_assert(sizeof(k_sigs) / sizeof(k_sigs[0]) <= 8, "run mask is 8 bits");
 
-// Hysteresis: require consecutive confirmations before switching blink state
-static uint8_t s_slow_hits = 0;
-static uint8_t s_fast_hits = 0;
+// Per-row likelihood score (0..255): a matching period adds LED_SCORE_HIT,
+// any other period decays it by 1/4. A glitch costs some score, not a full
+// re-acquisition. Continuous rows commit from here.
+static const uint8_t LED_SCORE_HIT = 80;
+static uint8_t s_score[SIG_COUNT];
 
-static inline uint16_t u16_sat(uint32_t v)
+// Continuous rows commit once the score reaches burst_min hits, less half a
+// hit of slack so one miss inside the run does not cost an extra period.
+static inline uint8_t score_commit(uint8_t burst_min)
 {
-    return (v > 0xFFFFu) ? 0xFFFFu : (uint16_t)v;
+    const uint16_t t = (uint16_t)burst_min * LED_SCORE_HIT - (LED_SCORE_HIT / 2u);
+    return (t > 255u) ? 255u : (uint8_t)t;
 }
 
-static inline bool in_blink(dvr_led_pattern_t p)
+#if CFG_DVR_LED_SELF_CAL
+// -----------------------------------------------------------------------------
+// Self-calibration
+//
+// Learned ON/OFF centres per calibratable row (0 = not learned). Matching
+// stays on the compiled windows (a swapped DVR is still recognised and then
+// re-learned); the single-pair press-commit envelope becomes the learned
+// centre +-1/8 instead of T_SLOW_FAST_*. Written only from dvr_led_poll()
+// with IRQs off; read by the classifier (possibly in ISR context).
+// -----------------------------------------------------------------------------
+static const uint8_t CAL_SAMPLES_LOG2 = 4;    // 16 matching pairs per estimate
+
+static led_cal_slot_t s_cal[LED_CAL_SLOTS];
+
+// Learning accumulators (classifier context)
+static uint8_t  s_lrn_row = SIG_NONE;
+static uint8_t  s_lrn_n   = 0;
+static uint32_t s_lrn_on_sum  = 0;
+static uint32_t s_lrn_off_sum = 0;
+static uint16_t s_lrn_on_min  = 0, s_lrn_on_max  = 0;
+static uint16_t s_lrn_off_min = 0, s_lrn_off_max = 0;
+static uint8_t  s_lrn_done    = 0;     // slot bits already learned this boot
+
+// Hand-off to dvr_led_poll() (EEPROM writes happen there, never in ISR)
+static volatile bool     s_lrn_ready  = false;
+static volatile uint8_t  s_lrn_slot   = 0;
+static volatile uint16_t s_lrn_on_u   = 0;
+static volatile uint16_t s_lrn_off_u  = 0;
+
+static inline void cal_tighten(uint16_t &lo, uint16_t &hi, uint16_t c, uint8_t shift)
 {
-    return (p == DVR_LED_SLOW_BLINK) || (p == DVR_LED_FAST_BLINK);
+    const uint16_t d = (uint16_t)(c >> shift);
+    if ((uint16_t)(c - d) > lo) lo = (uint16_t)(c - d);
+    if ((uint16_t)(c + d) < hi) hi = (uint16_t)(c + d);
 }
 
-static inline bool in_range_u16(uint16_t v, uint16_t lo, uint16_t hi)
+static inline bool cal_learned(const led_sig_t &sig)
 {
-    return (v >= lo) && (v <= hi);
+    return (sig.cal != SIG_NO_CAL) && (s_cal[sig.cal].on_u != 0);
 }
+#endif
 
-static inline dvr_led_pattern_t classify_from_measurements(uint16_t period_ms,
-                                                          uint16_t on_dur_ms,
-                                                          uint16_t off_dur_ms)
+static inline void sig_load(uint8_t i, led_sig_t &sig)
 {
-    // Primary: period gates the class
-    if (in_range_u16(period_ms, T_FAST_MIN_MS, T_FAST_MAX_MS))
+    memcpy_P(&sig, &k_sigs[i], sizeof(sig));
+}
+
+// One pass over the table: bit i set when row i accepts this ON+OFF pair.
+static uint8_t match_signatures(uint16_t period_u, uint16_t on_dur_u, uint16_t off_dur_u)
+{
+    uint8_t m = 0;
+    led_sig_t sig;
+
+    for (uint8_t i = 0; i < SIG_COUNT; i++)
     {
-        // Optional duty checks (kept tolerant): only apply if both edges non-zero
-        if (on_dur_ms && off_dur_ms)
+        sig_load(i, sig);
+        if (in_range_u16(period_u,  sig.per_min_u, sig.per_max_u) &&
+            in_range_u16(on_dur_u,  sig.on_min_u,  sig.on_max_u)  &&
+            in_range_u16(off_dur_u, sig.off_min_u, sig.off_max_u))
         {
-            if (!in_range_u16(on_dur_ms,  T_FAST_EDGE_MIN_MS, T_FAST_EDGE_MAX_MS)) return DVR_LED_UNKNOWN;
-            if (!in_range_u16(off_dur_ms, T_FAST_EDGE_MIN_MS, T_FAST_EDGE_MAX_MS)) return DVR_LED_UNKNOWN;
+            m |= (uint8_t)(1u << i);
         }
-        return DVR_LED_FAST_BLINK;
     }
+    return m;
+}
 
-    if (in_range_u16(period_ms, T_SLOW_MIN_MS, T_SLOW_MAX_MS))
+static inline void scores_reset(void)
+{
+    for (uint8_t i = 0; i < SIG_COUNT; i++)
+        s_score[i] = 0;
+}
+
+static inline void run_reset(void)
+{
+    s_run_mask  = 0;
+    s_run_len   = 0;
+    s_run_clean = false;
+}
+
+#if CFG_DVR_LED_FAST_COMMIT
+// Single-period SLOW commit: both edges and the period inside the tight
+// envelope, and the pair completes soon after our own record-toggle press.
+// The envelope is T_SLOW_FAST_*, or learned centre +-1/8 once calibrated.
+static inline bool slow_pair_is_unambiguous(const led_sig_t &sig,
+                                            uint16_t period_u,
+                                            uint16_t on_dur_u,
+                                            uint16_t off_dur_u,
+                                            uint32_t edge_tk)
+{
+    if (!s_press_valid)
+        return false;
+    if ((uint32_t)(edge_tk - s_press_tk) > LED_MS_TO_TK(T_LED_PRESS_PRIOR_MS))
+        return false;
+
+#if CFG_DVR_LED_SELF_CAL
+    if (cal_learned(sig))
     {
-        if (on_dur_ms && off_dur_ms)
-        {
-            if (!in_range_u16(on_dur_ms,  T_SLOW_EDGE_MIN_MS, T_SLOW_EDGE_MAX_MS)) return DVR_LED_UNKNOWN;
-            if (!in_range_u16(off_dur_ms, T_SLOW_EDGE_MIN_MS, T_SLOW_EDGE_MAX_MS)) return DVR_LED_UNKNOWN;
-        }
-        return DVR_LED_SLOW_BLINK;
+        const led_cal_slot_t &c = s_cal[sig.cal];
+        uint16_t on_lo  = 0, on_hi  = 0xFFFFu;
+        uint16_t off_lo = 0, off_hi = 0xFFFFu;
+        uint16_t per_lo = 0, per_hi = 0xFFFFu;
+        cal_tighten(on_lo,  on_hi,  c.on_u,  3);
+        cal_tighten(off_lo, off_hi, c.off_u, 3);
+        cal_tighten(per_lo, per_hi, (uint16_t)(c.on_u + c.off_u), 3);
+
+        return in_range_u16(period_u,  per_lo, per_hi) &&
+               in_range_u16(on_dur_u,  on_lo,  on_hi)  &&
+               in_range_u16(off_dur_u, off_lo, off_hi);
     }
+#else
+    (void)sig;
+#endif
 
-    return DVR_LED_UNKNOWN;
+    return in_range_u16(period_u,  LED_MS_TO_U(T_SLOW_FAST_MIN_MS),      LED_MS_TO_U(T_SLOW_FAST_MAX_MS)) &&
+           in_range_u16(on_dur_u,  LED_MS_TO_U(T_SLOW_FAST_EDGE_MIN_MS), LED_MS_TO_U(T_SLOW_FAST_EDGE_MAX_MS)) &&
+           in_range_u16(off_dur_u, LED_MS_TO_U(T_SLOW_FAST_EDGE_MIN_MS), LED_MS_TO_U(T_SLOW_FAST_EDGE_MAX_MS));
 }
+#endif
 
-void dvr_led_init(void)
+#if CFG_DVR_LED_SELF_CAL
+static inline void cal_learn_reset(void)
 {
-    pinMode(PIN_DVR_STAT, INPUT);
-    attachInterrupt(digitalPinToInterrupt(PIN_DVR_STAT), dvr_led_isr_change, CHANGE);
+    s_lrn_row = SIG_NONE;
+    s_lrn_n   = 0;
+}
 
-    const uint32_t now_ms = millis();
+// Feed one ON+OFF pair. Learns only while a calibratable row is committed
+// and fully supported (score 255), i.e. a confirmed, steady blink. After
+// 16 consecutive matching pairs with a tight spread, posts the centres for
+// dvr_led_poll() to persist. One estimate per row per boot.
+static void cal_learn(uint8_t m, uint16_t on_u, uint16_t off_u)
+{
+    const uint8_t row = s_pat_sig;
 
-    // Start in UNKNOWN until we've observed stability or blink cadence.
-    s_pat = DVR_LED_UNKNOWN;
+    if (row == SIG_NONE || !(m & (1u << row)) || s_score[row] != 255u)
+    {
+        cal_learn_reset();
+        return;
+    }
+
+    led_sig_t sig;
+    sig_load(row, sig);
+    if (sig.cal == SIG_NO_CAL || (s_lrn_done & (1u << sig.cal)) || s_lrn_ready)
+        return;
 
-    s_level = (uint8_t)digitalRead(PIN_DVR_STAT);
-    s_last_edge_ms = now_ms;
+    if (row != s_lrn_row)
+    {
+        s_lrn_row     = row;
+        s_lrn_n       = 0;
+        s_lrn_on_sum  = 0;
+        s_lrn_off_sum = 0;
+        s_lrn_on_min  = s_lrn_on_max  = on_u;
+        s_lrn_off_min = s_lrn_off_max = off_u;
+    }
 
-    s_prev_level = s_level;
-    s_prev_edge_us = micros();
+    s_lrn_on_sum  += on_u;
+    s_lrn_off_sum += off_u;
+    if (on_u  < s_lrn_on_min)  s_lrn_on_min  = on_u;
+    if (on_u  > s_lrn_on_max)  s_lrn_on_max  = on_u;
+    if (off_u < s_lrn_off_min) s_lrn_off_min = off_u;
+    if (off_u > s_lrn_off_max) s_lrn_off_max = off_u;
 
-    s_last_on_us  = 0;
-    s_last_off_us = 0;
+    if (++s_lrn_n < (1u << CAL_SAMPLES_LOG2))
+        return;
 
-    s_last_on_dur_ms = 0;
-    s_last_off_dur_ms = 0;
-    s_last_period_ms = 0;
+    const uint16_t on_c  = (uint16_t)(s_lrn_on_sum  >> CAL_SAMPLES_LOG2);
+    const uint16_t off_c = (uint16_t)(s_lrn_off_sum >> CAL_SAMPLES_LOG2);
 
-    s_slow_hits = 0;
-    s_fast_hits = 0;
+    // Spread must fit inside the +-1/8 press-commit envelope
+    if ((uint16_t)(s_lrn_on_max  - s_lrn_on_min)  <= (on_c  >> 2) &&
+        (uint16_t)(s_lrn_off_max - s_lrn_off_min) <= (off_c >> 2))
+    {
+        s_lrn_slot  = sig.cal;
+        s_lrn_on_u  = on_c;
+        s_lrn_off_u = off_c;
+        s_lrn_ready = true;
+        s_lrn_done |= (uint8_t)(1u << sig.cal);
+    }
 
-    clear_queue();
+    cal_learn_reset();
 }
+#endif
 
-void dvr_led_poll(uint32_t now_ms)
+// One edge in, bounded work out (one pass over the signature table).
+// Safe in ISR context: no division, no unbounded loops.
+//   held_u    : how long s_prev_level was held before this edge (units)
+//   lvl_after : level after the edge (HIGH/LOW)
+//   edge_tk   : edge timestamp (Timer1 ticks), for the press prior
+static void classify_edge(uint16_t held_u, uint8_t lvl_after, uint32_t edge_tk)
 {
-    // Always sample instantaneous level for SOLID/OFF decisions
-    const uint8_t level_now = (uint8_t)digitalRead(PIN_DVR_STAT);
-    s_level = level_now;
+    const uint8_t held_level = s_prev_level;
+    s_prev_level = lvl_after;
+
+    s_edge_count++;
 
-    // Drain all queued edges; compute real on/off durations and same-phase periods
-    uint32_t ts_us;
-    uint8_t lvl_after;
+    // Burst length of the committed blink (cleared by pat_set on any change)
+    if (in_blink(s_pat) && s_blink_edges < 255u)
+        s_blink_edges++;
 
-    while (pop_edge(ts_us, lvl_after))
+    // First edge after init/gap: its held duration is partial.
+    if (s_resync)
     {
-        s_last_edge_ms = now_ms;
+        s_resync    = false;
+        s_on_dur_u  = 0;
+        s_off_dur_u = 0;
+        return;
+    }
+
+    if (held_level == LOW) s_on_dur_u  = held_u;   // LED was ON
+    else                   s_off_dur_u = held_u;   // LED was OFF
 
-        // Adjacent-edge duration: s_prev_level was held until this edge
-        const uint32_t held_us = ts_us - s_prev_edge_us;
-        const uint16_t held_ms = u16_sat(held_us / 1000u);
+    // Need one full ON+OFF pair for a same-phase period
+    if (s_on_dur_u == 0 || s_off_dur_u == 0)
+        return;
+
+    const uint16_t per_u = (uint16_t)(s_on_dur_u + s_off_dur_u);   // <= 2*U_MAX fits
+    s_last_period_u = per_u;
 
-        if (s_prev_level == LOW)  s_last_on_dur_ms  = held_ms; // LED was ON
-        else                      s_last_off_dur_ms = held_ms; // LED was OFF
+    const uint8_t m    = match_signatures(per_u, s_on_dur_u, s_off_dur_u);
+    const uint8_t keep = (uint8_t)(s_run_mask & m);
 
-        // Update previous-edge tracking
-        s_prev_edge_us = ts_us;
-        s_prev_level   = lvl_after;
+    if (keep != 0)
+    {
+        s_run_mask = keep;
+        if (s_run_len < 255) s_run_len++;
+    }
+    else
+    {
+        // New (or no) candidate set for finite bursts
+        s_run_mask  = m;
+        s_run_len   = m ? 1 : 0;
+        s_run_clean = !in_blink(s_pat);
+    }
 
-        // Same-phase period: successive ON-edges or OFF-edges
-        const bool led_on_now = (lvl_after == LOW);
+    // Update every row's score; pick the best-supported continuous row.
+    // Finite bursts are only decided at quiet-time, once the terminal level
+    // is known.
+    uint8_t best   = SIG_NONE;
+    uint8_t best_s = 0;
+    uint8_t best_c = 255;
+    led_sig_t sig;
 
-        if (led_on_now)
+    for (uint8_t i = 0; i < SIG_COUNT; i++)
+    {
+        sig_load(i, sig);
+
+        uint8_t sc = s_score[i];
+        if (m & (1u << i))
         {
-            if (s_last_on_us != 0)
+            sc = (sc > (uint8_t)(255u - LED_SCORE_HIT)) ? 255u : (uint8_t)(sc + LED_SCORE_HIT);
+
+#if CFG_DVR_LED_FAST_COMMIT
+            // Fast path: first matching pair right after our record press
+            // lifts the row straight to its commit score.
+            const uint8_t need = score_commit(sig.burst_min);
+            if (sc < need && (sig.flags & SIG_F_PRESS_COMMIT) &&
+                slow_pair_is_unambiguous(sig, per_u, s_on_dur_u, s_off_dur_u, edge_tk))
             {
-                const uint16_t per_ms = u16_sat((ts_us - s_last_on_us) / 1000u);
-                s_last_period_ms = per_ms;
-
-                const dvr_led_pattern_t bp =
-                    classify_from_measurements(per_ms, s_last_on_dur_ms, s_last_off_dur_ms);
-
-                if (bp == DVR_LED_SLOW_BLINK)
-                {
-                    if (s_slow_hits < 255) s_slow_hits++;
-                    s_fast_hits = 0;
-                }
-                else if (bp == DVR_LED_FAST_BLINK)
-                {
-                    if (s_fast_hits < 255) s_fast_hits++;
-                    s_slow_hits = 0;
-                }
-                else
-                {
-                    // Transitional oddities reset confidence.
-                    s_slow_hits = 0;
-                    s_fast_hits = 0;
-                }
-
-                // Require 2 hits to change blink state (hysteresis)
-                if (s_slow_hits >= 2) s_pat = DVR_LED_SLOW_BLINK;
-                if (s_fast_hits >= 2) s_pat = DVR_LED_FAST_BLINK;
+                sc = need;
+                s_press_valid = false;   // one commit per press
             }
-            s_last_on_us = ts_us;
+#endif
         }
         else
         {
-            if (s_last_off_us != 0)
-            {
-                const uint16_t per_ms = u16_sat((ts_us - s_last_off_us) / 1000u);
-                s_last_period_ms = per_ms;
-
-                const dvr_led_pattern_t bp =
-                    classify_from_measurements(per_ms, s_last_on_dur_ms, s_last_off_dur_ms);
-
-                if (bp == DVR_LED_SLOW_BLINK)
-                {
-                    if (s_slow_hits < 255) s_slow_hits++;
-                    s_fast_hits = 0;
-                }
-                else if (bp == DVR_LED_FAST_BLINK)
-                {
-                    if (s_fast_hits < 255) s_fast_hits++;
-                    s_slow_hits = 0;
-                }
-                else
-                {
-                    s_slow_hits = 0;
-                    s_fast_hits = 0;
-                }
-
-                if (s_slow_hits >= 2) s_pat = DVR_LED_SLOW_BLINK;
-                if (s_fast_hits >= 2) s_pat = DVR_LED_FAST_BLINK;
-            }
-            s_last_off_us = ts_us;
+            sc = (sc > 3u) ? (uint8_t)(sc - (sc >> 2)) : 0u;
         }
+        s_score[i] = sc;
 
-        // NOTE: While edges are flowing, we never overwrite blink with SOLID/OFF here.
-        // Blink is sticky until quiet-time says blink ended.
+        if (sig.burst_max == 0 && sc > best_s)
+        {
+            best   = i;
+            best_s = sc;
+            best_c = score_commit(sig.burst_min);
+        }
+    }
+
+#if !CFG_DVR_LED_FAST_COMMIT
+    (void)edge_tk;
+#endif
+
+    if (best != SIG_NONE && best_s >= best_c)
+    {
+        sig_load(best, sig);
+        pat_set((dvr_led_pattern_t)sig.result, edge_tk);
+        s_pat_sig = best;
     }
 
-    // Quiet-time classification: only when genuinely quiet
-    const uint32_t quiet_ms = now_ms - s_last_edge_ms;
+#if CFG_DVR_LED_SELF_CAL
+    cal_learn(m, s_on_dur_u, s_off_dur_u);
+#endif
+
+    // Remember the cadence of the blink we are in (for the end-of-blink deadline).
+    // Non-matching periods (glitches) never shrink it.
+    if (s_pat_sig != SIG_NONE && (m & (1u << s_pat_sig)))
+        s_blink_period_u = per_u;
+
+    // NOTE: While edges are flowing, we never overwrite blink with SOLID/OFF here.
+    // Blink is sticky until quiet-time says blink ended.
+    if (in_blink(s_pat))
+        s_conf = s_score[s_pat_sig];
+}
+
+// Quiet-time: which row (if any) names the settled state at `level`?
+//  - a finished clean burst of the right length ending at its terminal level
+//  - or the burst already reported, while the LED stays at that level
+static uint8_t resolve_quiet(uint8_t level)
+{
+    const uint8_t term = (level == LOW) ? SIG_TERM_ON : SIG_TERM_OFF;
+    led_sig_t sig;
 
-    if (!in_blink(s_pat))
+    if (s_run_clean)
     {
-        if (quiet_ms >= (uint32_t)T_SOLID_MS)
+        for (uint8_t i = 0; i < SIG_COUNT; i++)
         {
-            s_pat = (s_level == LOW) ? DVR_LED_SOLID : DVR_LED_OFF;
-            s_slow_hits = 0;
-            s_fast_hits = 0;
+            if (!(s_run_mask & (1u << i)))
+                continue;
+
+            sig_load(i, sig);
+            if (sig.burst_max != 0 && sig.terminal == term &&
+                s_run_len >= sig.burst_min && s_run_len <= sig.burst_max)
+                return i;
         }
+    }
+
+    if (s_pat_sig != SIG_NONE)
+    {
+        sig_load(s_pat_sig, sig);
+        if (sig.burst_max != 0 && sig.terminal == term)
+            return s_pat_sig;
+    }
+
+    return SIG_NONE;
+}
+
+static inline void classifier_reset(uint8_t level, uint32_t now_tk)
+{
+    s_pat         = DVR_LED_UNKNOWN;
+    s_pat_tk      = now_tk;
+    s_blink_edges = 0;
+    s_conf        = 0;
+
+    s_prev_level = level;
+    s_resync     = true;
+
+    s_on_dur_u      = 0;
+    s_off_dur_u     = 0;
+    s_last_period_u = 0;
+    s_blink_period_u = 0;
+
+    run_reset();
+    scores_reset();
+    s_pat_sig = SIG_NONE;
+
+    s_last_edge_tk = now_tk;
+
+    s_press_valid = false;
+}
+
+#if !CFG_DVR_LED_ISR_CLASSIFIER
+// -----------------------------------------------------------------------------
+// ISR ring buffer: one uint16_t per edge
+//
+//   bit 15    : level AFTER the edge
+//   bit 14..0 : delta since previous stored edge, in units (saturating)
+//
+// Delta 0 never occurs for a real edge (glitch filter is 3 ms = 23 units), so
+// a zero-delta slot is the GAP marker: "edges were lost here".
+//
+// The ISR reference advances by the *quantised* delta, so the sub-unit
+// remainder carries into the next edge and rebuilt timestamps never drift.
+// Glitch-rejected or dropped edges do not advance it at all.
+// -----------------------------------------------------------------------------
+static const uint8_t  QN        = 64;       // power-of-two required
+static const uint16_t Q_LVL_BIT = 0x8000u;
+static const uint16_t Q_DT_MASK = 0x7FFFu;
+static const uint16_t Q_GAP     = 0x0000u;  // delta 0 => gap marker
+
+static volatile uint16_t s_q[QN];
+static volatile uint8_t  s_q_w = 0;
+static volatile uint8_t  s_q_r = 0;
+
+static volatile bool     s_q_gap_pending = false;  // dropped since last stored edge
+static volatile uint16_t s_q_dropped     = 0;      // saturating
+static volatile uint32_t s_q_sat_tk      = 0;      // true time of last saturated edge
+
+static uint32_t s_prev_edge_tk = 0;    // rebuilt timestamp of last drained edge
+#endif
+
+#if CFG_DVR_LED_STORM_GUARD
+static uint8_t s_isr_level = HIGH;    // last level fed to the edge path
+#endif
+
+// Accepted-edge path, shared by INT1 and the storm-mode sampler (ISR context).
+static inline void led_edge_in(uint8_t lvl, uint32_t now_tk)
+{
+    const uint32_t dt_tk = now_tk - s_last_isr_tk;
+
+    if (dt_tk < DVR_LED_GLITCH_TK)
         return;
+
+#if CFG_DVR_LED_STORM_GUARD
+    s_isr_level = lvl;
+#endif
+
+#if CFG_DVR_LED_ISR_CLASSIFIER
+    s_last_isr_tk  = now_tk;
+    s_last_edge_tk = now_tk;
+    classify_edge(tk_to_u_sat(dt_tk), lvl, now_tk);
+#else
+    const uint8_t w = s_q_w;
+    uint8_t w_next  = (uint8_t)((w + 1u) & (QN - 1u));
+
+    // Pending gap needs a marker slot in front of this edge
+    const uint8_t need_next = s_q_gap_pending ? (uint8_t)((w_next + 1u) & (QN - 1u)) : w_next;
+
+    if (w_next == s_q_r || need_next == s_q_r)
+    {
+        // overflow => drop, remember the gap (reference is NOT advanced)
+        s_q_gap_pending = true;
+        if (s_q_dropped != 0xFFFFu) s_q_dropped++;
     }
+    else
+    {
+        uint8_t wi = w;
+        if (s_q_gap_pending)
+        {
+            s_q[wi] = Q_GAP;
+            wi      = w_next;
+            w_next  = need_next;
+            s_q_gap_pending = false;
+        }
+
+        const uint16_t units = tk_to_u_sat(dt_tk);
+        s_q[wi] = (uint16_t)(units | (lvl ? Q_LVL_BIT : 0u));
+
+        if (units == U_MAX) s_last_isr_tk = s_q_sat_tk = now_tk;             // saturated: resync
+        else                s_last_isr_tk += (uint32_t)units << U_SHIFT;     // keep remainder
+
+        s_q_w = w_next;
+    }
+#endif
+}
 
-    // If we *were* blinking, only drop to SOLID/OFF after a long quiet.
-    // Use T_SOLID_MS + T_SLOW_MAX_MS as "blink has definitely stopped".
-    if (quiet_ms >= (uint32_t)T_SOLID_MS + (uint32_t)T_SLOW_MAX_MS)
+#if CFG_DVR_LED_STORM_GUARD
+// -----------------------------------------------------------------------------
+// Edge-storm guard
+//
+// A chattering sense line (loose wire, RF pickup) can fire INT1 at tens of
+// kHz; the 3 ms glitch reject still pays for every ISR entry. More than
+// STORM_EDGES raw INT1 entries inside STORM_WIN_TK masks INT1 and hands the
+// line to a 1 kHz Timer2 sampler with a 3-sample majority filter, feeding the
+// same edge path. Once a STORM_CLEAN_MS window shows at most STORM_CLEAN_MAX
+// samples disagreeing with the filter, INT1 is re-armed.
+//
+// Cost bound: INT1 runs at most STORM_EDGES times per re-arm, and re-arms
+// happen at most once per STORM_CLEAN_MS. The sampler is one short ISR/ms.
+// -----------------------------------------------------------------------------
+static const uint32_t STORM_WIN_TK    = 20u * HW_TIMER_TICKS_PER_MS;
+static const uint8_t  STORM_EDGES     = 8;      // > 400 edges/s; FAST blink is 10/s
+static const uint16_t STORM_CLEAN_MS  = 500;    // sampler window (1 sample/ms)
+static const uint8_t  STORM_CLEAN_MAX = 8;      // ~1 per real edge (filter lag)
+static const uint8_t  MAJ3_LUT        = 0xE8u;  // bit h set => majority HIGH in 3-bit history h
+
+static volatile bool     s_storm       = false;  // sampler owns the line
+static volatile uint16_t s_storm_trips = 0;      // saturating
+
+static uint32_t s_storm_win_tk = 0;
+static uint8_t  s_storm_cnt    = 0;
+
+static uint8_t  s_smp_hist  = 0;      // last 3 raw samples, bit0 newest
+static uint8_t  s_smp_level = HIGH;   // majority-filtered level
+static uint16_t s_smp_n     = 0;      // samples in current clean window
+static uint8_t  s_smp_bad   = 0;      // samples disagreeing with the filter
+
+static inline void sampler_start(void)
+{
+#ifdef __AVR__
+    TCCR2B = 0;
+    TCCR2A = _BV(WGM21);     // CTC on OCR2A
+    TCNT2  = 0;
+    OCR2A  = 249;            // 16 MHz / 64 / 250 = 1 kHz
+    TIFR2  = _BV(OCF2A);
+    TIMSK2 = _BV(OCIE2A);
+    TCCR2B = _BV(CS22);      // clk/64
+#endif
+}
+
+static inline void sampler_stop(void)
+{
+#ifdef __AVR__
+    TIMSK2 = 0;
+    TCCR2B = 0;
+#endif
+}
+
+// First thing in INT1. Returns true when a storm was declared (INT1 masked).
+static inline bool storm_check(uint32_t now_tk)
+{
+    if ((uint32_t)(now_tk - s_storm_win_tk) >= STORM_WIN_TK)
     {
-        s_pat = (s_level == LOW) ? DVR_LED_SOLID : DVR_LED_OFF;
-        s_slow_hits = 0;
-        s_fast_hits = 0;
+        s_storm_win_tk = now_tk;
+        s_storm_cnt    = 0;
+    }
+
+    if (++s_storm_cnt <= STORM_EDGES)
+        return false;
+
+    EIMSK &= (uint8_t)~_BV(INT1);
+    s_storm = true;
+    if (s_storm_trips != 0xFFFFu) s_storm_trips++;
+
+    // Seed the filter with the last level the classifier saw
+    s_smp_level = s_isr_level;
+    s_smp_hist  = s_isr_level ? 0x07u : 0x00u;
+    s_smp_n     = 0;
+    s_smp_bad   = 0;
+
+    sampler_start();
+    return true;
+}
+
+ISR(TIMER2_COMPA_vect)
+{
+    const uint8_t raw = DVR_STAT_LEVEL() ? 1u : 0u;
+    const uint8_t h   = (uint8_t)(((s_smp_hist << 1) | raw) & 0x07u);
+    s_smp_hist = h;
+
+    const uint8_t maj = ((MAJ3_LUT >> h) & 1u) ? HIGH : LOW;
+
+    if (maj != s_smp_level)
+    {
+        s_smp_level = maj;
+        led_edge_in(maj, hw_timer_now32_isr());
+    }
+
+    if (raw != maj && s_smp_bad != 0xFFu)
+        s_smp_bad++;
+
+    if (++s_smp_n < STORM_CLEAN_MS)
         return;
+
+    if (s_smp_bad <= STORM_CLEAN_MAX)
+    {
+        // Line is clean again: hand it back to INT1
+        sampler_stop();
+        s_storm        = false;
+        s_storm_cnt    = 0;
+        s_storm_win_tk = hw_timer_now32_isr();
+
+        EIFR   = _BV(INTF1);
+        EIMSK |= _BV(INT1);
+
+        // A change between the last sample and re-arm would be lost
+        const uint8_t lvl = DVR_STAT_LEVEL();
+        if (lvl != s_isr_level)
+            led_edge_in(lvl, hw_timer_now32_isr());
+    }
+
+    s_smp_n   = 0;
+    s_smp_bad = 0;
+}
+#endif
+
+// INT1 edge capture: sample PD3 first (closest to the edge), then Timer1.
+// Minimal work: no micros(), no attachInterrupt() trampoline.
+ISR(INT1_vect)
+{
+    ISR_STATS_INT1_ENTER();
+
+    const uint8_t  lvl    = DVR_STAT_LEVEL();   // level AFTER edge
+    const uint32_t now_tk = hw_timer_now32_isr();
+
+#if CFG_DVR_LED_STORM_GUARD
+    if (!storm_check(now_tk))
+#endif
+        led_edge_in(lvl, now_tk);
+
+    ISR_STATS_INT1_EXIT();
+}
+
+static inline void int1_enable_any_change(void)
+{
+#ifdef __AVR__
+    EICRA = (uint8_t)((EICRA & ~(_BV(ISC11) | _BV(ISC10))) | _BV(ISC10));   // any logical change
+    EIFR  = _BV(INTF1);                                                     // drop stale request
+    EIMSK |= _BV(INT1);
+#endif
+}
+
+#if !CFG_DVR_LED_ISR_CLASSIFIER
+static bool pop_edge(uint16_t &slot)
+{
+    noInterrupts();
+    if (s_q_r == s_q_w)
+    {
+        interrupts();
+        return false;
+    }
+    const uint8_t r = s_q_r;
+    slot  = s_q[r];
+    s_q_r = (uint8_t)((r + 1u) & (QN - 1u));
+    interrupts();
+    return true;
+}
+
+// Drain all queued edges into the classifier core
+static void drain_edges(void)
+{
+    uint16_t slot;
+
+    while (pop_edge(slot))
+    {
+        if (slot == Q_GAP)
+        {
+            // Edges were lost: phase history is no longer trustworthy.
+            // Restart same-phase period tracking from the next edge.
+            s_resync = true;
+            continue;
+        }
+
+        const uint16_t dt_u      = (uint16_t)(slot & Q_DT_MASK);
+        const uint8_t  lvl_after = (slot & Q_LVL_BIT) ? HIGH : LOW;
+
+        // Rebuild absolute edge time from the stored delta (quiet-time base).
+        // A saturated delta lost the real gap: take the ISR's resync time.
+        if (dt_u == U_MAX)
+        {
+            noInterrupts();
+            s_prev_edge_tk = s_q_sat_tk;
+            interrupts();
+        }
+        else
+        {
+            s_prev_edge_tk += (uint32_t)dt_u << U_SHIFT;
+        }
+        s_last_edge_tk  = s_prev_edge_tk;
+
+        classify_edge(dt_u, lvl_after, s_prev_edge_tk);
+    }
+}
+#endif
+
+#if CFG_DVR_LED_SELF_CAL
+// A learned slot is used only if its centres sit inside the compiled windows
+// of the row that owns it (guards an old record against a retuned table).
+static bool cal_slot_fits(uint8_t slot, const led_cal_slot_t &c)
+{
+    led_sig_t sig;
+
+    for (uint8_t i = 0; i < SIG_COUNT; i++)
+    {
+        sig_load(i, sig);
+        if (sig.cal != slot)
+            continue;
+
+        return (c.on_u != 0) &&
+               in_range_u16(c.on_u,  sig.on_min_u,  sig.on_max_u)  &&
+               in_range_u16(c.off_u, sig.off_min_u, sig.off_max_u) &&
+               in_range_u16((uint16_t)(c.on_u + c.off_u), sig.per_min_u, sig.per_max_u);
     }
+    return false;
+}
+
+static inline bool cal_close(uint16_t a, uint16_t ref)   // within 1/16
+{
+    const uint16_t d = (a > ref) ? (uint16_t)(a - ref) : (uint16_t)(ref - a);
+    return d <= (uint16_t)(ref >> 4);
+}
+
+// Main-loop side of learning: adopt a posted estimate, persist if it moved.
+static void cal_service(void)
+{
+    if (!s_lrn_ready)
+        return;
+
+    led_cal_slot_t c;
+
+    noInterrupts();
+    const uint8_t slot = s_lrn_slot;
+    c.on_u  = s_lrn_on_u;
+    c.off_u = s_lrn_off_u;
+    s_lrn_ready = false;
+    interrupts();
+
+    if (slot >= LED_CAL_SLOTS || !cal_slot_fits(slot, c))
+        return;
+
+    // Only this function writes s_cal, so reading it here needs no lock
+    const led_cal_slot_t &old = s_cal[slot];
+    if (old.on_u != 0 && cal_close(c.on_u, old.on_u) && cal_close(c.off_u, old.off_u))
+        return;   // no meaningful change: spare the EEPROM
+
+    noInterrupts();
+    s_cal[slot] = c;
+    interrupts();
+
+    led_cal_save(s_cal);
+}
+#endif
+
+void dvr_led_init(void)
+{
+    pinMode(PIN_DVR_STAT, INPUT);
+
+#if CFG_DVR_LED_SELF_CAL
+    // Learned windows, or compiled defaults when the record is absent/invalid
+    led_cal_slot_t cal[LED_CAL_SLOTS];
+    (void)led_cal_load(cal);
+    for (uint8_t i = 0; i < LED_CAL_SLOTS; i++)
+    {
+        if (!cal_slot_fits(i, cal[i]))
+            cal[i].on_u = cal[i].off_u = 0;
+    }
+#endif
+
+    const uint32_t now_tk = hw_timer_now32();
+
+    noInterrupts();
+
+#if CFG_DVR_LED_SELF_CAL
+    for (uint8_t i = 0; i < LED_CAL_SLOTS; i++)
+        s_cal[i] = cal[i];
+    cal_learn_reset();
+    s_lrn_done  = 0;
+    s_lrn_ready = false;
+#endif
+
+    // Start in UNKNOWN until we've observed stability or blink cadence.
+    classifier_reset(DVR_STAT_LEVEL(), now_tk);
+    s_last_isr_tk = now_tk;
+
+#if !CFG_DVR_LED_ISR_CLASSIFIER
+    s_q_r = s_q_w;
+    s_q_gap_pending = false;
+    s_q_dropped     = 0;
+    s_prev_edge_tk  = now_tk;
+#endif
+
+#if CFG_DVR_LED_STORM_GUARD
+    sampler_stop();
+    s_storm        = false;
+    s_storm_trips  = 0;
+    s_storm_cnt    = 0;
+    s_storm_win_tk = now_tk;
+    s_isr_level    = DVR_STAT_LEVEL();
+#endif
+
+    interrupts();
+
+    int1_enable_any_change();
+}
+
+void dvr_led_poll(uint32_t now_ms)
+{
+    (void)now_ms;
+
+#if !CFG_DVR_LED_ISR_CLASSIFIER
+    drain_edges();
+#endif
+
+#if CFG_DVR_LED_SELF_CAL
+    cal_service();
+#endif
+
+    // Quiet-time classification: only when genuinely quiet.
+    // Instantaneous level decides SOLID vs OFF. In ISR mode the classifier
+    // state is shared with INT1, so the (short) check runs with IRQs off.
+    noInterrupts();
+
+    const uint32_t quiet_tk = hw_timer_now32_isr() - s_last_edge_tk;
+    const dvr_led_pattern_t pat = s_pat;
+
+    // If we *were* blinking, drop to SOLID/OFF once the next edge is overdue:
+    // last matched period * 5/4 + slack, never longer than the legacy
+    // T_SOLID_MS + T_SLOW_MAX_MS "blink has definitely stopped" window.
+    uint32_t need_tk = LED_MS_TO_TK(T_SOLID_MS);
+
+    if (in_blink(pat))
+    {
+        const uint32_t cap_tk = LED_MS_TO_TK((uint32_t)T_SOLID_MS + (uint32_t)T_SLOW_MAX_MS);
+        const uint16_t per_u  = s_blink_period_u;
+
+        need_tk = cap_tk;
+        if (per_u != 0)
+        {
+            const uint32_t due_tk = ((uint32_t)(per_u + (per_u >> 2)) << U_SHIFT)
+                                  + LED_MS_TO_TK(T_BLINK_END_SLACK_MS);
+            if (due_tk < cap_tk)
+                need_tk = due_tk;
+
+            // A still-plausible slower hypothesis (e.g. SLOW decaying through
+            // a short chatter burst) keeps the blink alive to its own deadline.
+            led_sig_t sig;
+            for (uint8_t i = 0; i < SIG_COUNT; i++)
+            {
+                if (i == s_pat_sig || s_score[i] < (LED_SCORE_HIT / 4u))
+                    continue;
+
+                sig_load(i, sig);
+                if (sig.burst_max != 0)
+                    continue;
+
+                const uint32_t alt_tk = ((uint32_t)sig.per_max_u << U_SHIFT)
+                                      + LED_MS_TO_TK(T_BLINK_END_SLACK_MS);
+                if (alt_tk > need_tk)
+                    need_tk = (alt_tk < cap_tk) ? alt_tk : cap_tk;
+            }
+        }
+    }
+
+    if (quiet_tk >= need_tk)
+    {
+        const uint8_t  level  = DVR_STAT_LEVEL();
+        const uint8_t  sig_i  = resolve_quiet(level);
+        const uint32_t due_tk = s_last_edge_tk + need_tk;   // when it actually went quiet
+
+        if (sig_i != SIG_NONE)
+        {
+            led_sig_t sig;
+            sig_load(sig_i, sig);
+            pat_set((dvr_led_pattern_t)sig.result, due_tk);
+        }
+        else
+        {
+            pat_set((level == LOW) ? DVR_LED_SOLID : DVR_LED_OFF, due_tk);
+        }
+
+        s_pat_sig = sig_i;
+        s_conf    = 255;
+        run_reset();
+        scores_reset();
+        s_blink_period_u = 0;
+    }
+
+    interrupts();
 }
 
 dvr_led_pattern_t dvr_led_get_pattern(void)
 {
     return s_pat;
 }
+
+dvr_led_pattern_t dvr_led_get_pattern_since(uint32_t* since_tk)
+{
+    noInterrupts();
+    const dvr_led_pattern_t p = s_pat;
+    *since_tk = s_pat_tk;
+    interrupts();
+    return p;
+}
+
+void dvr_led_note_toggle_press(void)
+{
+    const uint32_t now_tk = hw_timer_now32();
+
+    noInterrupts();
+    s_press_tk    = now_tk;
+    s_press_valid = true;
+    interrupts();
+}
+
+uint8_t dvr_led_get_confidence(void)
+{
+    return s_conf;
+}
+
+uint8_t dvr_led_blink_edges(void)
+{
+    return s_blink_edges;
+}
+
+uint16_t dvr_led_edge_count(void)
+{
+    noInterrupts();
+    const uint16_t n = s_edge_count;
+    interrupts();
+    return n;
+}
+
+uint16_t dvr_led_dropped_edges(void)
+{
+#if CFG_DVR_LED_ISR_CLASSIFIER
+    return 0;   // no ring, nothing to drop
+#else
+    noInterrupts();
+    const uint16_t n = s_q_dropped;
+    interrupts();
+    return n;
+#endif
+}
+
+bool dvr_led_storm_active(void)
+{
+#if CFG_DVR_LED_STORM_GUARD
+    return s_storm;
+#else
+    return false;
+#endif
+}
+
+uint16_t dvr_led_storm_trips(void)
+{
+#if CFG_DVR_LED_STORM_GUARD
+    noInterrupts();
+    const uint16_t n = s_storm_trips;
+    interrupts();
+    return n;
+#else
+    return 0;
+#endif
+}
+
+bool dvr_led_cal_get(uint8_t slot, uint16_t* on_ms, uint16_t* off_ms)
+{
+#if CFG_DVR_LED_SELF_CAL
+    if (slot < LED_CAL_SLOTS && s_cal[slot].on_u != 0)
+    {
+        *on_ms  = (uint16_t)(((uint32_t)s_cal[slot].on_u  * 128u + 500u) / 1000u);
+        *off_ms = (uint16_t)(((uint32_t)s_cal[slot].off_u * 128u + 500u) / 1000u);
+        return true;
+    }
+#else
+    (void)slot;
+#endif
+    *on_ms  = 0;
+    *off_ms = 0;
+    return false;
+}
+
+void dvr_led_cal_clear(void)
+{
+#if CFG_DVR_LED_SELF_CAL
+    noInterrupts();
+    for (uint8_t i = 0; i < LED_CAL_SLOTS; i++)
+        s_cal[i].on_u = s_cal[i].off_u = 0;
+    s_lrn_done = 0;
+    interrupts();
+
+    led_cal_erase();
+#endif
+}
@@ -0,0 +1,186 @@
+// dvr_reconcile.cpp
+//
+// Commanded vs LED-observed DVR state reconciliation (see dvr_reconcile.h).
+// Main-loop context only; decides, the FSM applies.
+
+#include "dvr_reconcile.h"
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "timings.h"
+#include "drv_dvr_status.h"
+
+// -----------------------------------------------------------------------------
+// Internal state
+// -----------------------------------------------------------------------------
+static dvr_view_t s_intent       = DVR_VIEW_OFF;
+static dvr_view_t s_obs          = DVR_VIEW_UNKNOWN;
+static uint32_t   s_obs_since_ms = 0;
+
+// Unplanned ON -> not-ON drop (candidate reboot)
+static bool       s_dropped      = false;
+static uint32_t   s_drop_ms      = 0;
+
+static dvr_reconcile_stats_t s_stats;
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+static inline bool time_reached(uint32_t now, uint32_t deadline)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+static inline void stat_inc(uint16_t& c)
+{
+    if (c != 0xFFFFu) c++;
+}
+
+static inline bool view_on(dvr_view_t v)
+{
+    return (v == DVR_VIEW_IDLE) || (v == DVR_VIEW_RECORDING);
+}
+
+static dvr_view_t view_from_led(dvr_led_pattern_t p)
+{
+    switch (p)
+    {
+        case DVR_LED_OFF:        return DVR_VIEW_OFF;
+        case DVR_LED_SOLID:      return DVR_VIEW_IDLE;
+        case DVR_LED_SLOW_BLINK: return DVR_VIEW_RECORDING;
+        default:                 return DVR_VIEW_UNKNOWN;
+    }
+}
+
+static dvr_view_t view_from_fsm(controller_state_t st)
+{
+    switch (st)
+    {
+        case STATE_OFF:       return DVR_VIEW_OFF;
+        case STATE_IDLE:      return DVR_VIEW_IDLE;
+        case STATE_RECORDING: return DVR_VIEW_RECORDING;
+        default:              return DVR_VIEW_UNKNOWN;   // booting / error / low bat / lockout
+    }
+}
+
+// Track LED view changes that happened without a gesture of ours in flight
+static void observe(uint32_t now_ms, dvr_view_t v, bool ours)
+{
+    if (v == s_obs)
+        return;
+
+    const dvr_view_t prev = s_obs;
+    s_obs          = v;
+    s_obs_since_ms = now_ms;
+
+    if (ours)
+    {
+        s_dropped = false;
+        return;
+    }
+
+    // SOLID <-> SLOW with nothing of ours pending: physical record button
+    if (view_on(prev) && view_on(v))
+    {
+        s_intent = v;
+        stat_inc(s_stats.followed);
+        return;
+    }
+
+    // ON -> anything else: maybe a reboot, maybe a real power-off
+    if (view_on(prev) && !s_dropped)
+    {
+        s_dropped = true;
+        s_drop_ms = now_ms;
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+void dvr_reconcile_init(void)
+{
+    s_intent       = DVR_VIEW_OFF;
+    s_obs          = DVR_VIEW_UNKNOWN;
+    s_obs_since_ms = 0;
+    s_dropped      = false;
+    s_drop_ms      = 0;
+
+    s_stats.adopted  = 0;
+    s_stats.followed = 0;
+    s_stats.restored = 0;
+}
+
+void dvr_reconcile_note_gesture(dvr_gesture_t g)
+{
+    switch (g)
+    {
+        case DVR_GEST_REC_START: s_intent = DVR_VIEW_RECORDING; break;
+        case DVR_GEST_REC_STOP:  s_intent = DVR_VIEW_IDLE;      break;
+        case DVR_GEST_POWER_ON:  s_intent = DVR_VIEW_IDLE;      break;
+        case DVR_GEST_POWER_OFF: s_intent = DVR_VIEW_OFF;       break;
+        default: break;
+    }
+    s_dropped = false;
+}
+
+bool dvr_reconcile_poll(uint32_t now_ms, controller_state_t fsm_state, dvr_reconcile_fix_t* out)
+{
+    out->adopt   = DVR_VIEW_UNKNOWN;
+    out->gesture = DVR_GEST_NONE;
+
+    const bool ours = (dvr_confirm_pending() != DVR_GEST_NONE);
+    observe(now_ms, view_from_led(drv_dvr_status_last_led_pattern()), ours);
+
+    // Let our own gestures and the LED settle first
+    if (ours || s_obs == DVR_VIEW_UNKNOWN)
+        return false;
+    if (!time_reached(now_ms, s_obs_since_ms + (uint32_t)T_RECONCILE_SETTLE_MS))
+        return false;
+
+    const dvr_view_t belief = view_from_fsm(fsm_state);
+    if (belief == DVR_VIEW_UNKNOWN)
+        return false;
+
+    if (belief != s_obs)
+    {
+        out->adopt = s_obs;
+        stat_inc(s_stats.adopted);
+    }
+
+    // Back on after an unplanned drop: restore recording if that was the intent
+    if (s_dropped && view_on(s_obs))
+    {
+        s_dropped = false;
+
+        if (s_obs == DVR_VIEW_IDLE && s_intent == DVR_VIEW_RECORDING &&
+            !time_reached(now_ms, s_drop_ms + (uint32_t)T_RECONCILE_REBOOT_MS))
+        {
+            out->gesture = DVR_GEST_REC_START;
+            stat_inc(s_stats.restored);
+        }
+        else
+        {
+            s_intent = s_obs;
+        }
+    }
+    else if (s_dropped && time_reached(now_ms, s_drop_ms + (uint32_t)T_RECONCILE_REBOOT_MS))
+    {
+        // Stayed down: treat as a real power-off, stop wanting anything back
+        s_dropped = false;
+        s_intent  = s_obs;
+    }
+
+    return (out->adopt != DVR_VIEW_UNKNOWN) || (out->gesture != DVR_GEST_NONE);
+}
+
+dvr_view_t dvr_reconcile_intent(void)
+{
+    return s_intent;
+}
+
+void dvr_reconcile_get_stats(dvr_reconcile_stats_t* out)
+{
+    *out = s_stats;
+}
@@ -20,6 +20,12 @@ static inline uint8_t next_index(uint8_t idx)
     return idx;
 }
 
+static inline uint8_t prev_index(uint8_t idx)
+{
+    if (idx == 0) idx = CFG_EVENT_QUEUE_SIZE;
+    return (uint8_t)(idx - 1);
+}
+
 void eventq_init(void)
 {
 #ifdef __AVR__
@@ -99,6 +105,31 @@ static inline bool push_core(const event_t *e)
     return true;
 }
 
+// Core head-of-line insert (interrupts already disabled). Never refused: on a
+// full queue the newest queued event is discarded to make room.
+static inline bool push_front_core(const event_t *e)
+{
+    bool ok = true;
+    uint8_t p = prev_index(s_tail);
+
+    // Full if the slot before tail is the (always free) head slot.
+    if (p == s_head)
+    {
+        s_head = prev_index(s_head);
+        s_dropped++;
+        ok = false;
+    }
+
+    s_buf[p] = *e;
+    s_tail = p;
+    return ok;
+}
+
+bool eventq_push_front_isr(const event_t *e)
+{
+    return push_front_core(e);
+}
+
 bool eventq_push_isr(const event_t *e)
 {
     // In AVR ISR context, global interrupts are already disabled.
@@ -14,6 +14,9 @@
 //
 // Notes:
 // - Uses actionq_pop()/actionq_push() to preserve FIFO when actions cannot be serviced yet.
+// - CFG_DVR_UART: record toggles (ACT_DVR_PRESS_SHORT, arg0 = dvr_gesture_t) go
+//   over the RunCam UART (rcdp) while the link is up; otherwise, and for power
+//   gestures, the press engine runs as before.
 // - We treat LED as non-blocking (never a reason to stall other actions).
 
 #include <Arduino.h>
@@ -22,6 +25,9 @@
 #include <timings.h>
 #include "pins.h"
 #include "action_queue.h"
+#include "dvr_led.h"
+#include "dvr_confirm.h"
+#include "rcdp.h"
 
 // ----------------------------------------------------------------------------
 // Internal state (independent engines)
@@ -44,23 +50,23 @@ static uint32_t       s_dvr_next_ms   = 0;
 static uint16_t       s_dvr_press_ms  = 0;
 
 // ----------------------------------------------------------------------------
-// HW helpers
+// HW helpers (compile-time pins: one sbi/cbi each, see fast_gpio.h)
 // ----------------------------------------------------------------------------
 
 static inline void led_set(bool on)
 {
-    digitalWrite(PIN_STATUS_LED, on ? STATUS_LED_ON_LEVEL : STATUS_LED_OFF_LEVEL);
+    pin_status_led_t::write(on ? STATUS_LED_ON_LEVEL : STATUS_LED_OFF_LEVEL);
 }
 
 static inline void buzz_set(bool on)
 {
-    digitalWrite(PIN_BUZZER_OUT, on ? BUZZER_ON_LEVEL : BUZZER_OFF_LEVEL);
+    pin_buzzer_t::write(on ? BUZZER_ON_LEVEL : BUZZER_OFF_LEVEL);
 }
 
-// DVR button emulation helper (uses pins.h names verbatim)
+// DVR button emulation helper (uses pins.h descriptors verbatim)
 static inline void dvr_btn_set(bool pressed)
 {
-    digitalWrite(PIN_DVR_BTN_CMD, pressed ? DVR_BTN_PRESS_LEVEL : DVR_BTN_RELEASE_LEVEL);
+    pin_dvr_btn_t::write(pressed ? DVR_BTN_PRESS_LEVEL : DVR_BTN_RELEASE_LEVEL);
 }
 
 // ----------------------------------------------------------------------------
@@ -108,6 +114,10 @@ void executor_init(void)
     dvr_btn_set(false);
 
     executor_abort_feedback();
+
+#if CFG_DVR_UART
+    rcdp_init(0);
+#endif
 }
 
 // ----------------------------------------------------------------------------
@@ -249,6 +259,22 @@ static bool start_dvr_press(uint32_t now_ms, uint16_t press_ms)
     return true;
 }
 
+#if CFG_DVR_UART
+// Record toggle over UART; false => use the button (link down, no feature,
+// or a press still running that the command must not overtake)
+static bool start_dvr_uart(uint16_t gesture)
+{
+    if (s_dvr_active)
+        return false;
+
+    uint8_t action = 0;
+    if (gesture == DVR_GEST_REC_START) action = RCDP_CTRL_START_RECORDING;
+    if (gesture == DVR_GEST_REC_STOP)  action = RCDP_CTRL_STOP_RECORDING;
+
+    return (action != 0) && rcdp_request(action);
+}
+#endif
+
 static void dvr_step(uint32_t now_ms)
 {
     if (!s_dvr_active) return;
@@ -271,6 +297,11 @@ static void dvr_step(uint32_t now_ms)
 
 void executor_poll(uint32_t now_ms)
 {
+#if CFG_DVR_UART
+    // 0) RunCam link first, so rcdp_request() sees a fresh link state
+    rcdp_poll(now_ms);
+#endif
+
     // 1) Dispatch actions, but NEVER drop ones we cannot execute.
     enum { STASH_MAX = 16 };
     action_t stash[STASH_MAX];
@@ -297,7 +328,13 @@ void executor_poll(uint32_t now_ms)
                 break;
 
             case ACT_DVR_PRESS_SHORT:
-                handled = start_dvr_press(now_ms, (uint16_t)T_DVR_PRESS_SHORT_MS);
+#if CFG_DVR_UART
+                handled = start_dvr_uart(a.arg0);
+                if (!handled)
+#endif
+                    handled = start_dvr_press(now_ms, (uint16_t)T_DVR_PRESS_SHORT_MS);
+                if (handled)
+                    dvr_led_note_toggle_press();   // prior for LED record confirmation
                 break;
 
             case ACT_DVR_PRESS_LONG:
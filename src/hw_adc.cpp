@@ -0,0 +1,217 @@
+// hw_adc.cpp
+//
+// Auto-triggered, ISR-oversampled battery ADC (see hw_adc.h).
+
+#include "hw_adc.h"
+
+#include <Arduino.h>
+
+#ifdef __AVR__
+  #include <avr/interrupt.h>
+  #include <util/atomic.h>
+#endif
+
+#ifdef __AVR__
+static const uint8_t MUX_BAT     = _BV(REFS0);            // AVCC ref, ADC0
+static const uint8_t MUX_BANDGAP = _BV(REFS0) | 0x0E;     // AVCC ref, 1.1 V bandgap
+#endif
+
+// Conversion slots: the battery runs continuously, a bandgap slot is spliced
+// in after every HW_ADC_BG_EVERY batches. The first conversion after each
+// mux switch is thrown away (bandgap buffer / 22k divider settling).
+enum adc_seq_t : uint8_t
+{
+    SEQ_BAT = 0,
+    SEQ_BG_SETTLE,
+    SEQ_BG,
+    SEQ_BAT_SETTLE
+};
+
+// -----------------------------------------------------------------------------
+// ISR-owned accumulation, published result
+// -----------------------------------------------------------------------------
+static uint16_t          s_acc    = 0;     // running sum (max 16 * 1023 fits)
+static uint8_t           s_n      = 0;     // conversions in s_acc
+static volatile uint16_t s_result = 0;
+static volatile bool     s_ready  = false;
+
+static uint8_t           s_seq     = SEQ_BAT;
+static uint8_t           s_batches = 0;    // battery batches since last bandgap slot
+static uint16_t          s_bg_acc  = 0;
+static uint8_t           s_bg_n    = 0;
+static volatile uint16_t s_bg      = 0;    // last bandgap sum, 12-bit scale (0 = none yet)
+
+// Threshold trip (one-shot; s_trip_fn == 0 means disarmed)
+static hw_adc_trip_fn    s_trip_fn    = 0;
+static uint16_t          s_trip_level = 0;
+static uint8_t           s_trip_need  = 1;
+static uint8_t           s_trip_run   = 0;     // consecutive filtered conversions <= level
+static uint16_t          s_trip_filt  = 0;     // EMA of raw, x 2^HW_ADC_TRIP_EMA_SHIFT
+static bool              s_trip_seed  = true;  // next conversion seeds the EMA
+
+#ifdef __AVR__
+ISR(ADC_vect)
+{
+    const uint16_t raw = ADC;
+
+    switch (s_seq)
+    {
+        case SEQ_BG_SETTLE:
+            s_seq = SEQ_BG;
+            return;
+
+        case SEQ_BG:
+            s_bg_acc += raw;
+            if (++s_bg_n < HW_ADC_BG_SAMPLES)
+                return;
+            s_bg     = s_bg_acc;
+            s_bg_acc = 0;
+            s_bg_n   = 0;
+            ADMUX    = MUX_BAT;            // next trigger converts the battery
+            s_seq    = SEQ_BAT_SETTLE;
+            return;
+
+        case SEQ_BAT_SETTLE:
+            s_seq = SEQ_BAT;
+            return;
+
+        default:
+            break;
+    }
+
+    // Trip first: the hook runs within a few us of the conversion completing
+    if (s_trip_fn)
+    {
+        if (s_trip_seed)
+        {
+            s_trip_filt = (uint16_t)(raw << HW_ADC_TRIP_EMA_SHIFT);
+            s_trip_seed = false;
+        }
+        else
+        {
+            s_trip_filt = (uint16_t)(s_trip_filt + raw - (s_trip_filt >> HW_ADC_TRIP_EMA_SHIFT));
+        }
+
+        const uint16_t filt = (uint16_t)(s_trip_filt >> HW_ADC_TRIP_EMA_SHIFT);
+
+        if (filt > s_trip_level)
+        {
+            s_trip_run = 0;
+        }
+        else if (++s_trip_run >= s_trip_need)
+        {
+            const hw_adc_trip_fn fn = s_trip_fn;
+            s_trip_fn = 0;
+            fn(filt);
+        }
+    }
+
+    s_acc += raw;
+
+    if (++s_n < HW_ADC_OS_SAMPLES)
+        return;
+
+    s_result = (uint16_t)(s_acc >> HW_ADC_OS_SHIFT);
+    s_ready  = true;
+    s_acc    = 0;
+    s_n      = 0;
+
+    if (++s_batches >= HW_ADC_BG_EVERY)
+    {
+        s_batches = 0;
+        ADMUX     = MUX_BANDGAP;
+        s_seq     = SEQ_BG_SETTLE;
+    }
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+void hw_adc_init(void)
+{
+#ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        ADCSRA = 0;                                   // off while reconfiguring
+        ADMUX  = MUX_BAT;                             // AVCC ref, right-adjusted, ADC0
+        DIDR0 |= _BV(ADC0D);                          // no digital buffer on the divider pin
+        ADCSRB = _BV(ADTS2);                          // trigger: Timer0 overflow
+        s_acc     = 0;
+        s_n       = 0;
+        s_ready   = false;
+        s_seq     = SEQ_BAT;
+        s_batches = 0;
+        s_bg_acc  = 0;
+        s_bg_n    = 0;
+        s_bg      = 0;
+        ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIE) | _BV(ADIF)   // ADIF: clear stale
+               | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);           // clk/128
+    }
+#endif
+}
+
+bool hw_adc_take(uint16_t* out)
+{
+    bool ok = false;
+#ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        ok = s_ready;
+        if (ok)
+        {
+            *out    = s_result;
+            s_ready = false;
+        }
+    }
+#else
+    (void)out;
+#endif
+    return ok;
+}
+
+uint16_t hw_adc_bandgap(void)
+{
+    uint16_t v = 0;
+#ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE) { v = s_bg; }
+#endif
+    return v;
+}
+
+void hw_adc_trip_arm(uint16_t level, uint8_t conversions, hw_adc_trip_fn fn)
+{
+#ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#endif
+    {
+        s_trip_level = level;
+        s_trip_need  = conversions ? conversions : 1;
+        s_trip_run   = 0;
+        s_trip_seed  = true;
+        s_trip_fn    = fn;
+    }
+}
+
+void hw_adc_trip_set_level(uint16_t level)
+{
+#ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#endif
+    {
+        s_trip_level = level;
+    }
+}
+
+bool hw_adc_trip_disarm(void)
+{
+    bool was_armed;
+#ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#endif
+    {
+        was_armed = (s_trip_fn != 0);
+        s_trip_fn = 0;
+    }
+    return was_armed;
+}
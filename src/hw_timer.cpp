@@ -0,0 +1,53 @@
+// hw_timer.cpp
+//
+// Timer1 free-running timestamp counter (see hw_timer.h).
+//
+// The Arduino core init() leaves Timer1 in 8-bit phase-correct PWM mode at
+// prescaler 64. We take it over here: normal mode, no compare outputs, /8,
+// overflow interrupt extends the count to 32 bits.
+
+#include "hw_timer.h"
+
+#include <Arduino.h>
+
+#ifdef __AVR__
+  #include <avr/interrupt.h>
+  #include <util/atomic.h>
+#endif
+
+volatile uint16_t g_hw_timer_ovf = 0;
+
+#ifdef __AVR__
+ISR(TIMER1_OVF_vect)
+{
+    g_hw_timer_ovf++;
+}
+#endif
+
+void hw_timer_init(void)
+{
+#ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        TCCR1A = 0;              // normal mode, OC1A/OC1B disconnected
+        TCCR1B = 0;              // stop while reconfiguring
+        TCNT1  = 0;
+        g_hw_timer_ovf = 0;
+        TIFR1  = 0xFF;           // clear stale flags (write-1-to-clear)
+        TIMSK1 = _BV(TOIE1);     // overflow => extend to 32 bits
+        TCCR1B = _BV(CS11);      // clk/8 => 2 MHz
+    }
+#endif
+}
+
+uint32_t hw_timer_now32(void)
+{
+    uint32_t t = 0;
+#ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        t = hw_timer_now32_isr();
+    }
+#endif
+    return t;
+}
@@ -0,0 +1,118 @@
+// isr_stats.cpp
+//
+// Interrupt latency / duration instrumentation (see isr_stats.h).
+//
+// Owns Timer1 COMPB (OCR1B / OCIE1B). Timer1 itself is owned by hw_timer and
+// must already be running (call hw_timer_init() first).
+
+#include "isr_stats.h"
+
+#if CFG_ISR_STATS
+
+#include <Arduino.h>
+
+#ifdef __AVR__
+  #include <avr/interrupt.h>
+  #include <util/atomic.h>
+#endif
+
+// -----------------------------------------------------------------------------
+// Module-local tuning
+// -----------------------------------------------------------------------------
+static const uint16_t kProbePeriodTk = 2000;   // 1 ms between probes
+static const uint16_t kAvgWindow     = 1024;   // halve sum/count at this many
+
+// -----------------------------------------------------------------------------
+// State (written from ISR context)
+// -----------------------------------------------------------------------------
+volatile uint16_t g_isr_int1_count       = 0;
+volatile uint16_t g_isr_int1_dur_max_tk  = 0;
+volatile uint16_t g_isr_int1_dur_last_tk = 0;
+
+static volatile uint16_t s_probe_count  = 0;
+static volatile uint16_t s_lat_max_tk   = 0;
+static volatile uint32_t s_lat_sum_tk   = 0;
+static volatile uint16_t s_lat_sum_n    = 0;
+
+#ifdef __AVR__
+ISR(TIMER1_COMPB_vect)
+{
+    const uint16_t now = TCNT1;
+    const uint16_t lat = (uint16_t)(now - OCR1B);
+
+    // Re-arm from the counter, not from the last match: after a latency
+    // longer than the period, OCR1B + period would already lie behind TCNT1
+    // and the next match would only come after a full 32 ms Timer1 wrap.
+    OCR1B = (uint16_t)(now + kProbePeriodTk);
+
+    if (lat > s_lat_max_tk) s_lat_max_tk = lat;
+
+    s_lat_sum_tk += lat;
+    if (++s_lat_sum_n >= kAvgWindow)
+    {
+        s_lat_sum_tk >>= 1;
+        s_lat_sum_n  >>= 1;
+    }
+
+    if (s_probe_count != 0xFFFFu) s_probe_count++;
+}
+#endif
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+void isr_stats_init(void)
+{
+    isr_stats_reset();
+
+#ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+    {
+        OCR1B  = (uint16_t)(TCNT1 + kProbePeriodTk);
+        TIFR1  = _BV(OCF1B);       // drop any stale match
+        TIMSK1 |= _BV(OCIE1B);
+    }
+#endif
+}
+
+void isr_stats_reset(void)
+{
+#ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#endif
+    {
+        g_isr_int1_count       = 0;
+        g_isr_int1_dur_max_tk  = 0;
+        g_isr_int1_dur_last_tk = 0;
+
+        s_probe_count = 0;
+        s_lat_max_tk  = 0;
+        s_lat_sum_tk  = 0;
+        s_lat_sum_n   = 0;
+    }
+}
+
+void isr_stats_get(isr_stats_t *out)
+{
+    if (!out) return;
+
+    uint32_t sum;
+    uint16_t n;
+
+#ifdef __AVR__
+    ATOMIC_BLOCK(ATOMIC_RESTORESTATE)
+#endif
+    {
+        out->probe_count      = s_probe_count;
+        out->lat_max_tk       = s_lat_max_tk;
+        out->int1_count       = g_isr_int1_count;
+        out->int1_dur_max_tk  = g_isr_int1_dur_max_tk;
+        out->int1_dur_last_tk = g_isr_int1_dur_last_tk;
+        sum = s_lat_sum_tk;
+        n   = s_lat_sum_n;
+    }
+
+    out->lat_avg_tk = n ? (uint16_t)(sum / n) : 0;
+}
+
+#endif // CFG_ISR_STATS
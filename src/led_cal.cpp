@@ -0,0 +1,62 @@
+// led_cal.cpp
+//
+// DVR LED calibration record in EEPROM (see led_cal.h).
+
+#include "led_cal.h"
+
+#include <Arduino.h>
+#include <string.h>
+
+#include "config.h"
+#include "crc8.h"
+
+#ifdef __AVR__
+  #include <avr/eeprom.h>
+#endif
+
+// Bump when the slot layout or unit changes: old records then load as blank.
+static const uint8_t LED_CAL_VERSION = 1;
+
+typedef struct
+{
+    uint8_t        version;
+    led_cal_slot_t slot[LED_CAL_SLOTS];
+    uint8_t        crc;
+} __attribute__((packed)) led_cal_rec_t;
+
+static_assert(sizeof(led_cal_rec_t) == LED_CAL_RECORD_LEN, "EEPROM layout");
+
+static inline uint8_t rec_crc(const led_cal_rec_t* r)
+{
+    return crc8_dvb_s2(r, (uint8_t)(sizeof(*r) - 1u));
+}
+
+bool led_cal_load(led_cal_slot_t slots[LED_CAL_SLOTS])
+{
+    led_cal_rec_t r;
+    eeprom_read_block(&r, (const void*)CFG_EE_LED_CAL_ADDR, sizeof(r));
+
+    if (r.version != LED_CAL_VERSION || r.crc != rec_crc(&r))
+    {
+        memset(slots, 0, sizeof(r.slot));
+        return false;
+    }
+
+    memcpy(slots, r.slot, sizeof(r.slot));
+    return true;
+}
+
+void led_cal_save(const led_cal_slot_t slots[LED_CAL_SLOTS])
+{
+    led_cal_rec_t r;
+    r.version = LED_CAL_VERSION;
+    memcpy(r.slot, slots, sizeof(r.slot));
+    r.crc = rec_crc(&r);
+
+    eeprom_update_block(&r, (void*)CFG_EE_LED_CAL_ADDR, sizeof(r));
+}
+
+void led_cal_erase(void)
+{
+    eeprom_update_byte((uint8_t*)CFG_EE_LED_CAL_ADDR, 0xFFu);   // blank version
+}
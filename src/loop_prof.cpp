@@ -0,0 +1,104 @@
+// loop_prof.cpp
+//
+// Per-stage loop profiler (see loop_prof.h).
+//
+// RAM: PROF_STAGE_COUNT * (sizeof(prof_stat_t) + 4 accumulator + 2 dt) bytes.
+// Everything here compiles away when CFG_LOOP_PROFILER == 0.
+
+#include "loop_prof.h"
+
+#if CFG_LOOP_PROFILER
+
+#include <string.h>
+
+// -----------------------------------------------------------------------------
+// Hot-path state (written by the inline marks in loop_prof.h)
+// -----------------------------------------------------------------------------
+uint16_t g_prof_t_prev = 0;
+uint16_t g_prof_dt[PROF_STAGE_COUNT];
+
+// -----------------------------------------------------------------------------
+// Internal state
+// -----------------------------------------------------------------------------
+static prof_stat_t s_stat[PROF_STAGE_COUNT];
+static uint32_t    s_sum_tk[PROF_STAGE_COUNT];   // running sum for average
+static uint16_t    s_sum_n[PROF_STAGE_COUNT];    // samples in s_sum_tk
+
+// Average window: once this many samples are summed, halve sum + count so
+// the average tracks recent behaviour and the sum can never overflow.
+static const uint16_t kAvgWindow = 1024;
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+static inline uint8_t hist_bin(uint16_t dt)
+{
+    // bit-length / 2 (rounded up), clamped: two octaves per bin
+    uint8_t b = 0;
+    while (dt != 0u && b < (PROF_HIST_BINS - 1u))
+    {
+        dt >>= 2;
+        b++;
+    }
+    return b;
+}
+
+static inline void sat_inc(uint16_t &v)
+{
+    if (v != 0xFFFFu) v++;
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+void loop_prof_init(void)
+{
+    loop_prof_reset();
+}
+
+void loop_prof_reset(void)
+{
+    memset(s_stat,    0, sizeof(s_stat));
+    memset(s_sum_tk,  0, sizeof(s_sum_tk));
+    memset(s_sum_n,   0, sizeof(s_sum_n));
+    memset(g_prof_dt, 0, sizeof(g_prof_dt));
+
+    for (uint8_t i = 0; i < PROF_STAGE_COUNT; i++)
+        s_stat[i].min_tk = 0xFFFFu;
+
+    g_prof_t_prev = hw_timer_now16();
+}
+
+void loop_prof_fold(void)
+{
+    for (uint8_t i = 0; i < PROF_STAGE_COUNT; i++)
+    {
+        const uint16_t dt = g_prof_dt[i];
+        prof_stat_t &st = s_stat[i];
+
+        if (dt < st.min_tk) st.min_tk = dt;
+        if (dt > st.max_tk) st.max_tk = dt;
+
+        s_sum_tk[i] += dt;
+        if (++s_sum_n[i] >= kAvgWindow)
+        {
+            s_sum_tk[i] >>= 1;
+            s_sum_n[i]  >>= 1;
+        }
+
+        sat_inc(st.samples);
+        sat_inc(st.hist[hist_bin(dt)]);
+    }
+}
+
+bool loop_prof_get(uint8_t stage, prof_stat_t *out)
+{
+    if (stage >= PROF_STAGE_COUNT || !out)
+        return false;
+
+    *out = s_stat[stage];
+    out->avg_tk = s_sum_n[stage] ? (uint16_t)(s_sum_tk[stage] / s_sum_n[stage]) : 0;
+    return true;
+}
+
+#endif // CFG_LOOP_PROFILER
@@ -2,7 +2,7 @@
     SMOKE TEST (ARCH): controller_fsm + ui_policy + executor + drv_fuel_gauge + drv_dvr_led + drv_dvr_status
 
     - main.cpp is plumbing + observability only.
-    - dvr_button is the ONLY producer of EV_BTN_* events (polling).
+    - dvr_button is the ONLY producer of EV_BTN_* events (INT0 edge capture).
     - drv_fuel_gauge produces EV_BAT_* events (polling).
     - drv_dvr_led owns the dvr_led classifier and produces EV_DVR_LED_PATTERN_CHANGED.
     - drv_dvr_status consumes EV_DVR_LED_PATTERN_CHANGED and emits semantic EV_DVR_* events, incl EV_DVR_ERROR.
@@ -36,6 +36,11 @@
 
 #include "controller_fsm.h"
 
+#include "hw_timer.h"
+#include "isr_stats.h"
+#include "loop_prof.h"
+#include "telemetry.h"
+
 // ----------------------------------------------------------------------------
 // Time helper
 // ----------------------------------------------------------------------------
@@ -143,6 +148,12 @@ static void battery_status_print_periodic(uint32_t now)
     Serial.print(bat_state_str(st));
     Serial.print(F(" adc="));
     Serial.print(adc);
+    Serial.print(F(" est="));
+    Serial.print(drv_fuel_gauge_est_adc());
+    Serial.print(F(" load="));
+    Serial.print((uint8_t)drv_fuel_gauge_load());
+    Serial.print(F(" vcc="));
+    Serial.print(drv_fuel_gauge_vcc_mv());
     Serial.print(F(" lockout="));
     Serial.println(lockout ? F("YES") : F("NO"));
 #else
@@ -150,7 +161,8 @@ static void battery_status_print_periodic(uint32_t now)
 #endif
 }
 
-// Log EV_BAT_* events but preserve the queue for everyone else (stash+repush)
+// Log EV_BAT_* events; every event, BAT ones included, goes back on the
+// queue for the controller (stash+repush)
 static void battery_event_log_poll(void)
 {
 #if CFG_DEBUG_SERIAL
@@ -159,7 +171,7 @@ static void battery_event_log_poll(void)
     uint8_t n = 0;
 
     event_t ev;
-    while (eventq_pop(&ev))
+    while (n < STASH_MAX && eventq_pop(&ev))
     {
         if (ev.id == EV_BAT_STATE_CHANGED ||
             ev.id == EV_BAT_LOCKOUT_ENTER ||
@@ -173,13 +185,9 @@ static void battery_event_log_poll(void)
             Serial.print(ev.arg1);
             Serial.print(F(" reason="));
             Serial.println((uint16_t)ev.reason);
-            continue;
         }
 
-        if (n < STASH_MAX)
-            stash[n++] = ev;
-        else
-            break;
+        stash[n++] = ev;
     }
 
     for (uint8_t i = 0; i < n; i++)
@@ -199,6 +207,13 @@ void setup()
 #endif
 
     pins_init();
+    hw_timer_init();
+#if CFG_LOOP_PROFILER
+    loop_prof_init();
+#endif
+#if CFG_ISR_STATS
+    isr_stats_init();
+#endif
 
     eventq_init();
     actionq_init();
@@ -214,6 +229,8 @@ void setup()
     // Policy/FSM
     controller_fsm_init();
 
+    telemetry_init();
+
 #if CFG_DEBUG_SERIAL
     Serial.println(F("SMOKE(ARCH): controller_fsm + ui_policy + executor + drv_fuel_gauge + drv_dvr_led + drv_dvr_status"));
 #endif
@@ -223,24 +240,39 @@ void loop()
 {
     const uint32_t now = millis();
 
+    PROF_LOOP_BEGIN();
+
     // 1) Low-level producers -> events
     button_poll(now);
+    PROF_STAGE(PROF_ST_BUTTON);
+
     drv_fuel_gauge_poll(now);
+    PROF_STAGE(PROF_ST_FUEL_GAUGE);
 
     // 2) DVR LED classifier + bridge -> EV_DVR_LED_PATTERN_CHANGED
     drv_dvr_led_poll(now);
+    PROF_STAGE(PROF_ST_DVR_LED);
 
     // 3) DVR semantic discriminator (consumes LED pattern events, emits EV_DVR_* incl EV_DVR_ERROR)
     drv_dvr_status_poll(now);
+    PROF_STAGE(PROF_ST_DVR_STATUS);
 
     // 4) Observability (does NOT touch action_queue; event_queue only via safe stash for BAT logging)
     battery_event_log_poll();
     battery_status_print_periodic(now);
     dvr_led_observe_and_check_shutdown(now);
+    PROF_STAGE(PROF_ST_OBSERVE);
+
+    telemetry_poll(now);
+    PROF_STAGE(PROF_ST_TELEMETRY);
 
     // 5) Controller consumes events -> emits actions
     controller_fsm_poll(now);
+    PROF_STAGE(PROF_ST_FSM);
 
     // 6) Executor consumes actions -> drives outputs/press engines
     executor_poll(now);
+    PROF_STAGE(PROF_ST_EXECUTOR);
+
+    PROF_LOOP_END();
 }
@@ -0,0 +1,72 @@
+// mem_stats.cpp
+//
+// Stack painting + SRAM budget readback (see mem_stats.h).
+
+#include "mem_stats.h"
+
+#include <Arduino.h>
+
+#ifdef __AVR__
+  #include <avr/io.h>
+#endif
+
+#define MEM_STATS_PAINT  0xC5
+
+#ifdef __AVR__
+
+extern uint8_t _end;          // end of .bss/.noinit (linker)
+extern uint8_t __stack;       // initial SP (RAMEND)
+
+// -----------------------------------------------------------------------------
+// Reset-time painter (.init1: SP is valid, r1 is not yet cleared, so no C)
+// -----------------------------------------------------------------------------
+extern "C" void mem_stats_paint(void) __attribute__((naked, used, section(".init1")));
+
+extern "C" void mem_stats_paint(void)
+{
+    __asm__ volatile (
+        "    ldi r30, lo8(_end)      \n"
+        "    ldi r31, hi8(_end)      \n"
+        "    ldi r24, %0             \n"
+        "    ldi r25, hi8(__stack)   \n"
+        "    rjmp 2f                 \n"
+        "1:  st  Z+, r24             \n"
+        "2:  cpi r30, lo8(__stack)   \n"
+        "    cpc r31, r25            \n"
+        "    brlo 1b                 \n"
+        "    breq 1b                 \n"
+        :
+        : "i" (MEM_STATS_PAINT)
+    );
+}
+
+#endif // __AVR__
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+void mem_stats_get(mem_stats_t *out)
+{
+    if (!out) return;
+
+#ifdef __AVR__
+    const uint8_t *lo  = &_end;
+    const uint8_t *top = &__stack;
+    const uint8_t *p   = lo;
+
+    while (p <= top && *p == MEM_STATS_PAINT)
+        p++;
+
+    const uint16_t sp = SP;
+
+    out->static_bytes = (uint16_t)((uintptr_t)lo - RAMSTART);
+    out->never_used   = (uint16_t)(p - lo);
+    out->stack_peak   = (uint16_t)(top - p + 1);
+    out->stack_now    = (uint16_t)((uintptr_t)top - sp);
+#else
+    out->static_bytes = 0;
+    out->never_used   = 0;
+    out->stack_peak   = 0;
+    out->stack_now    = 0;
+#endif
+}
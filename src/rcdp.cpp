@@ -0,0 +1,242 @@
+// rcdp.cpp
+//
+// RunCam Device Protocol link (see rcdp.h). Main-loop context only: the UART
+// driver's own ISRs buffer the bytes, this module never waits on them.
+
+#include "rcdp.h"
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "timings.h"
+#include "hw_timer.h"
+#include "crc8.h"
+
+#ifndef CFG_DVR_UART_BAUD
+#define CFG_DVR_UART_BAUD 115200
+#endif
+
+static const uint8_t INFO_REPLY_LEN = 5;   // CC ver feat_lo feat_hi crc
+
+// -----------------------------------------------------------------------------
+// Internal state
+// -----------------------------------------------------------------------------
+static const rcdp_io_t* s_io = 0;
+
+static bool     s_up       = false;
+static uint16_t s_features = 0;
+
+// Outstanding GET_DEVICE_INFO (keepalive or command ack)
+static bool     s_wait         = false;
+static bool     s_wait_is_ack  = false;
+static uint32_t s_wait_until   = 0;     // ms
+static uint32_t s_wait_tk      = 0;     // send time (Timer1 ticks)
+static uint32_t s_next_probe   = 0;     // ms
+
+static uint8_t  s_pending      = 0;     // CAMERA_CONTROL action to send (0 = none)
+
+// Reply assembly
+static uint8_t  s_rx[INFO_REPLY_LEN];
+static uint8_t  s_rx_n = 0;
+
+static rcdp_stats_t s_stats;
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+static inline bool time_reached(uint32_t now, uint32_t deadline)
+{
+    return (int32_t)(now - deadline) >= 0;
+}
+
+static inline void stat_inc(uint16_t& c)
+{
+    if (c != 0xFFFFu) c++;
+}
+
+// Default I/O: hardware UART, TX only when the whole frame fits the buffer
+static int16_t serial_rx(void)
+{
+    return (int16_t)Serial.read();
+}
+
+static bool serial_tx(const uint8_t* buf, uint8_t len)
+{
+    if (Serial.availableForWrite() < (int)len)
+        return false;
+    Serial.write(buf, len);
+    return true;
+}
+
+static const rcdp_io_t k_serial_io = { serial_rx, serial_tx };
+
+static inline uint8_t frame_put(uint8_t* f, uint8_t n)
+{
+    f[n] = crc8_dvb_s2(f, n);
+    return (uint8_t)(n + 1);
+}
+
+static void link_down(uint32_t now_ms)
+{
+    s_up         = false;
+    s_wait       = false;
+    s_pending    = 0;
+    s_rx_n       = 0;
+    s_next_probe = now_ms + (uint32_t)T_RCDP_PROBE_MS;
+}
+
+static void on_info_reply(uint32_t now_ms)
+{
+    s_up       = true;
+    s_features = (uint16_t)(s_rx[2] | ((uint16_t)s_rx[3] << 8));
+
+    if (s_wait && s_wait_is_ack)
+    {
+        s_stats.last_rtt_tk = hw_timer_now32() - s_wait_tk;
+        stat_inc(s_stats.acks);
+    }
+
+    s_wait       = false;
+    s_next_probe = now_ms + (uint32_t)T_RCDP_PROBE_MS;
+}
+
+static void rx_drain(uint32_t now_ms)
+{
+    int16_t c;
+    while ((c = s_io->rx()) >= 0)
+    {
+        const uint8_t b = (uint8_t)c;
+
+        if (s_rx_n == 0 && b != RCDP_HEADER)
+            continue;   // hunt for the header
+
+        s_rx[s_rx_n++] = b;
+        if (s_rx_n < INFO_REPLY_LEN)
+            continue;
+
+        s_rx_n = 0;
+        if (crc8_dvb_s2(s_rx, INFO_REPLY_LEN - 1) == s_rx[INFO_REPLY_LEN - 1])
+            on_info_reply(now_ms);
+        else
+            stat_inc(s_stats.crc_errors);
+    }
+}
+
+// Send [control frame +] info probe in one all-or-nothing write
+static bool send(uint32_t now_ms, uint8_t action)
+{
+    uint8_t f[7];
+    uint8_t n = 0;
+
+    if (action)
+    {
+        f[0] = RCDP_HEADER;
+        f[1] = RCDP_CMD_CAMERA_CONTROL;
+        f[2] = action;
+        n = frame_put(f, 3);
+    }
+
+    f[n]     = RCDP_HEADER;
+    f[n + 1] = RCDP_CMD_GET_DEVICE_INFO;
+    n = (uint8_t)(n + frame_put(&f[n], 2));
+
+    const uint32_t t_tk = hw_timer_now32();
+    if (!s_io->tx(f, n))
+        return false;
+
+    s_wait        = true;
+    s_wait_is_ack = (action != 0);
+    s_wait_tk     = t_tk;
+    s_wait_until  = now_ms + (uint32_t)T_RCDP_RESP_MS;
+
+    stat_inc(s_stats.probes);
+    if (action)
+        stat_inc(s_stats.commands);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+void rcdp_init(const rcdp_io_t* io)
+{
+    if (io)
+    {
+        s_io = io;
+    }
+    else
+    {
+        Serial.begin(CFG_DVR_UART_BAUD);
+        s_io = &k_serial_io;
+    }
+
+    s_features = 0;
+    link_down(millis());
+    s_next_probe = millis();   // discover straight away
+
+    s_stats.probes      = 0;
+    s_stats.commands    = 0;
+    s_stats.acks        = 0;
+    s_stats.timeouts    = 0;
+    s_stats.crc_errors  = 0;
+    s_stats.last_rtt_tk = 0;
+}
+
+void rcdp_poll(uint32_t now_ms)
+{
+    if (!s_io)
+        return;
+
+    rx_drain(now_ms);
+
+    if (s_wait)
+    {
+        if (!time_reached(now_ms, s_wait_until))
+            return;
+
+        stat_inc(s_stats.timeouts);
+        link_down(now_ms);
+        return;
+    }
+
+    if (s_pending && s_up)
+    {
+        if (send(now_ms, s_pending))
+            s_pending = 0;
+        return;
+    }
+
+    if (time_reached(now_ms, s_next_probe))
+        (void)send(now_ms, 0);
+}
+
+bool rcdp_link_up(void)
+{
+    return s_up;
+}
+
+uint16_t rcdp_features(void)
+{
+    return s_features;
+}
+
+bool rcdp_request(uint8_t action)
+{
+    if (!s_up || s_pending || (s_wait && s_wait_is_ack))
+        return false;
+
+    uint16_t need = 0;
+    if (action == RCDP_CTRL_START_RECORDING) need = RCDP_FEAT_START_RECORDING;
+    if (action == RCDP_CTRL_STOP_RECORDING)  need = RCDP_FEAT_STOP_RECORDING;
+
+    if (need == 0 || !(s_features & need))
+        return false;
+
+    s_pending = action;
+    return true;
+}
+
+void rcdp_get_stats(rcdp_stats_t* out)
+{
+    *out = s_stats;
+}
@@ -0,0 +1,295 @@
+// telemetry.cpp
+//
+// On-demand diagnostics over the debug serial port (see telemetry.h).
+
+#include "telemetry.h"
+
+#include <Arduino.h>
+
+#include "config.h"
+#include "loop_prof.h"
+#include "isr_stats.h"
+#include "mem_stats.h"
+#include "dvr_led.h"
+#include "dvr_button.h"
+#include "led_cal.h"
+#include "dvr_confirm.h"
+#include "dvr_reconcile.h"
+#include "drv_fuel_gauge.h"
+#include "bat_runtime.h"
+
+#if CFG_DEBUG_SERIAL
+
+// Decimal argument typed ahead of a command letter ("7400k"); 0 = none
+static uint16_t s_arg = 0;
+
+// -----------------------------------------------------------------------------
+// Helpers
+// -----------------------------------------------------------------------------
+static void print_help(void)
+{
+    Serial.println(F("TELEM: ? help, m memory/stack report, g DVR gesture report"));
+    Serial.println(F("TELEM: b battery report, <mV>k battery calibration point, K battery calibration clear"));
+#if CFG_DVR_LED_SELF_CAL
+    Serial.println(F("TELEM: c LED calibration report, C LED calibration clear"));
+#endif
+#if CFG_LOOP_PROFILER
+    Serial.println(F("TELEM: p profiler report, P profiler reset"));
+#endif
+#if CFG_ISR_STATS
+    Serial.println(F("TELEM: i isr stats report, I isr stats reset"));
+#endif
+}
+
+#if CFG_LOOP_PROFILER
+static const __FlashStringHelper* prof_stage_str(uint8_t st)
+{
+    switch (st)
+    {
+        case PROF_ST_BUTTON:     return F("button");
+        case PROF_ST_FUEL_GAUGE: return F("fuel_gauge");
+        case PROF_ST_DVR_LED:    return F("dvr_led");
+        case PROF_ST_DVR_STATUS: return F("dvr_status");
+        case PROF_ST_OBSERVE:    return F("observe");
+        case PROF_ST_TELEMETRY:  return F("telemetry");
+        case PROF_ST_FSM:        return F("fsm");
+        case PROF_ST_EXECUTOR:   return F("executor");
+        default:                 return F("?");
+    }
+}
+
+static void print_profiler(void)
+{
+    Serial.println(F("PROF: stage n min avg max [hist] (tick=0.5us=8cyc)"));
+
+    prof_stat_t st;
+    for (uint8_t i = 0; i < PROF_STAGE_COUNT; i++)
+    {
+        if (!loop_prof_get(i, &st))
+            continue;
+
+        Serial.print(F("PROF: "));
+        Serial.print(prof_stage_str(i));
+        Serial.print(' ');
+        Serial.print(st.samples);
+        Serial.print(' ');
+        Serial.print(st.samples ? st.min_tk : 0);
+        Serial.print(' ');
+        Serial.print(st.avg_tk);
+        Serial.print(' ');
+        Serial.print(st.max_tk);
+        Serial.print(F(" ["));
+        for (uint8_t b = 0; b < PROF_HIST_BINS; b++)
+        {
+            if (b) Serial.print(' ');
+            Serial.print(st.hist[b]);
+        }
+        Serial.println(']');
+    }
+}
+#endif
+
+#if CFG_ISR_STATS
+static void print_isr_stats(void)
+{
+    isr_stats_t st;
+    isr_stats_get(&st);
+
+    Serial.print(F("ISR: probe n="));
+    Serial.print(st.probe_count);
+    Serial.print(F(" lat_avg="));
+    Serial.print(st.lat_avg_tk);
+    Serial.print(F(" lat_max="));
+    Serial.print(st.lat_max_tk);
+    Serial.println(F(" (tick=0.5us)"));
+
+    Serial.print(F("ISR: int1 n="));
+    Serial.print(st.int1_count);
+    Serial.print(F(" dur_last="));
+    Serial.print(st.int1_dur_last_tk);
+    Serial.print(F(" dur_max="));
+    Serial.println(st.int1_dur_max_tk);
+
+    Serial.print(F("ISR: led dropped="));
+    Serial.print(dvr_led_dropped_edges());
+    Serial.print(F(" storms="));
+    Serial.print(dvr_led_storm_trips());
+    Serial.print(F(" storm_active="));
+    Serial.println(dvr_led_storm_active() ? 1 : 0);
+
+    Serial.print(F("ISR: btn dropped="));
+    Serial.println(button_dropped_edges());
+}
+#endif
+
+static void print_mem_stats(void)
+{
+    mem_stats_t st;
+    mem_stats_get(&st);
+
+    Serial.print(F("MEM: static="));
+    Serial.print(st.static_bytes);
+    Serial.print(F(" stack_peak="));
+    Serial.print(st.stack_peak);
+    Serial.print(F(" stack_now="));
+    Serial.print(st.stack_now);
+    Serial.print(F(" never_used="));
+    Serial.println(st.never_used);
+}
+
+static void print_gestures(void)
+{
+    dvr_confirm_stats_t st;
+    dvr_confirm_get_stats(&st);
+
+    Serial.print(F("GEST: issued="));
+    Serial.print(st.issued);
+    Serial.print(F(" confirmed="));
+    Serial.print(st.confirmed);
+    Serial.print(F(" retries="));
+    Serial.print(st.retries);
+    Serial.print(F(" failed="));
+    Serial.print(st.failed);
+    Serial.print(F(" pending="));
+    Serial.println((uint8_t)dvr_confirm_pending());
+
+    dvr_reconcile_stats_t rs;
+    dvr_reconcile_get_stats(&rs);
+
+    Serial.print(F("GEST: reconcile intent="));
+    Serial.print((uint8_t)dvr_reconcile_intent());
+    Serial.print(F(" adopted="));
+    Serial.print(rs.adopted);
+    Serial.print(F(" followed="));
+    Serial.print(rs.followed);
+    Serial.print(F(" restored="));
+    Serial.println(rs.restored);
+}
+
+static void print_battery(void)
+{
+    bat_cal_t cal;
+    drv_fuel_gauge_cal_get(&cal);
+
+    Serial.print(F("BAT: adc="));
+    Serial.print(drv_fuel_gauge_last_adc());
+    Serial.print(F(" est="));
+    Serial.print(drv_fuel_gauge_est_adc());
+    Serial.print(F(" load="));
+    Serial.print((uint8_t)drv_fuel_gauge_load());
+    Serial.print(F(" vcc="));
+    Serial.print(drv_fuel_gauge_vcc_mv());
+    Serial.print(F(" soc="));
+    Serial.print(bat_runtime_soc_permille());
+    Serial.print(F(" rec_min="));
+    Serial.println(bat_runtime_rec_minutes());
+
+    Serial.print(F("BAT: cal gain_q14="));
+    Serial.print(cal.gain_q14);
+    Serial.print(F(" offset="));
+    Serial.println(cal.offset);
+}
+
+static void bat_cal_point(void)
+{
+    if (s_arg == 0)
+    {
+        Serial.println(F("BAT: cal needs the pack voltage, e.g. 7400k"));
+        return;
+    }
+
+    const bool ok = drv_fuel_gauge_cal_point(s_arg);
+    Serial.print(F("BAT: cal "));
+    Serial.print(s_arg);
+    Serial.println(ok ? F(" mV stored") : F(" mV rejected"));
+    if (ok)
+        print_battery();
+}
+
+#if CFG_DVR_LED_SELF_CAL
+static void print_led_cal(void)
+{
+    for (uint8_t slot = 0; slot < LED_CAL_SLOTS; slot++)
+    {
+        uint16_t on_ms, off_ms;
+        const bool learned = dvr_led_cal_get(slot, &on_ms, &off_ms);
+
+        Serial.print(F("LEDCAL: "));
+        Serial.print(slot == 0 ? F("fast") : F("slow"));
+        if (!learned)
+        {
+            Serial.println(F(" default"));
+            continue;
+        }
+        Serial.print(F(" on="));
+        Serial.print(on_ms);
+        Serial.print(F(" off="));
+        Serial.print(off_ms);
+        Serial.println(F(" ms"));
+    }
+}
+#endif
+
+static void handle_cmd(char c)
+{
+    if (c >= '0' && c <= '9')
+    {
+        const uint16_t d = (uint16_t)(c - '0');
+        s_arg = (s_arg > 6553u) ? 0xFFFFu : (uint16_t)(s_arg * 10u + d);
+        return;
+    }
+
+    switch (c)
+    {
+#if CFG_LOOP_PROFILER
+        case 'p': print_profiler(); break;
+        case 'P': loop_prof_reset(); Serial.println(F("PROF: reset")); break;
+#endif
+#if CFG_ISR_STATS
+        case 'i': print_isr_stats(); break;
+        case 'I': isr_stats_reset(); Serial.println(F("ISR: reset")); break;
+#endif
+        case 'm': print_mem_stats(); break;
+        case 'g': print_gestures(); break;
+        case 'b': print_battery(); break;
+        case 'k': bat_cal_point(); break;
+        case 'K': drv_fuel_gauge_cal_clear(); Serial.println(F("BAT: cal cleared")); break;
+#if CFG_DVR_LED_SELF_CAL
+        case 'c': print_led_cal(); break;
+        case 'C': dvr_led_cal_clear(); Serial.println(F("LEDCAL: cleared")); break;
+#endif
+        case '?': print_help(); break;
+        default:  break;   // ignore CR/LF and unknown bytes
+    }
+
+    s_arg = 0;   // any non-digit ends an argument
+}
+
+// -----------------------------------------------------------------------------
+// Public API
+// -----------------------------------------------------------------------------
+void telemetry_init(void)
+{
+    s_arg = 0;
+}
+
+void telemetry_poll(uint32_t now_ms)
+{
+    (void)now_ms;
+
+    while (Serial.available() > 0)
+        handle_cmd((char)Serial.read());
+}
+
+#else // !CFG_DEBUG_SERIAL
+
+void telemetry_init(void)
+{
+}
+
+void telemetry_poll(uint32_t now_ms)
+{
+    (void)now_ms;
+}
+
+#endif // CFG_DEBUG_SERIAL
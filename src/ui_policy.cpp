@@ -117,6 +117,13 @@ void ui_policy_on_stop_confirmed(uint32_t now_ms)
     beep(now_ms, BEEP_SINGLE);
 }
 
+void ui_policy_on_runtime_low(uint32_t now_ms, uint16_t minutes_left)
+{
+    // Same cue as LOW_BAT entry, ahead of it; LED stays with the state.
+    (void)minutes_left;
+    beep(now_ms, BEEP_LOW_BAT);
+}
+
 void ui_policy_on_error(uint32_t now_ms, error_code_t err)
 {
     (void)err;